@@ -0,0 +1,249 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <filesystem>
+#include <list>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "FileOrderedReader.h"
+#include "FPTreeManager.h"
+#include "FPTreeNode.h"
+#include "FrequentItemsets.h"
+#include "FrequentPatternMiner.h"
+#include "HeaderTable.h"
+#include "Params.h"
+
+using namespace std;
+
+// Dense dataset used by the microbenchmarks, small enough to rebuild its FP-Tree at every iteration
+static const string MICRO_DATASET = "mushroom.dat";
+static constexpr double MICRO_SUPPORT = 0.2;
+
+/**
+ * Gives the microbenchmarks access to the private steps of the mining, the datasets are read once and shared by all of
+ * them.
+ */
+struct Benchmarks {
+	static string getPath(const string& dataset) {
+		return string(DATASET_DIRECTORY) + "/" + dataset;
+	}
+
+	static const vector<list<int>>& getTransactions(const string& dataset) {
+		static map<string, vector<list<int>>> transactions;
+		if (!transactions.contains(dataset)) {
+			FileOrderedReader reader(getPath(dataset));
+			vector<list<int>>& datasetTransactions = transactions[dataset];
+			while (!reader.isEOF()) {
+				list<int> transaction = reader.getNextOrderedTransaction();
+				if (!transaction.empty()) {
+					datasetTransactions.push_back(move(transaction));
+				}
+			}
+		}
+		return transactions.at(dataset);
+	}
+
+	static const FPTreeManager<int>& getManager(const string& dataset) {
+		static map<string, unique_ptr<FPTreeManager<int>>> managers;
+		if (!managers.contains(dataset)) {
+			FileOrderedReader reader(getPath(dataset));
+			managers[dataset] = make_unique<FPTreeManager<int>>(reader, MICRO_SUPPORT);
+		}
+		return *managers.at(dataset);
+	}
+
+	static const FPTreeManager<int>& getPrunedManager(const string& dataset) {
+		static map<string, unique_ptr<FPTreeManager<int>>> managers;
+		if (!managers.contains(dataset)) {
+			managers[dataset] = make_unique<FPTreeManager<int>>(getManager(dataset));
+			managers[dataset]->pruneInfrequent();
+		}
+		return *managers.at(dataset);
+	}
+
+	static void addSequence(benchmark::State& state) {
+		const vector<list<int>>& transactions = getTransactions(MICRO_DATASET);
+		for (auto _ : state) {
+			shared_ptr<FPTreeNode<int>> root = make_shared<FPTreeNode<int>>(-1, nullptr);
+			HeaderTable<int> headerTable;
+			for (const list<int>& transaction : transactions) {
+				list<int> items = transaction;
+				root->addSequence(items, headerTable, 1);
+			}
+			benchmark::DoNotOptimize(root);
+		}
+		state.SetItemsProcessed(state.iterations() * transactions.size());
+	}
+
+	static void getPrefixTree(benchmark::State& state) {
+		const FPTreeManager<int>& manager = getPrunedManager(MICRO_DATASET);
+		const vector<int> items = manager.headerTable.getItems();
+		for (auto _ : state) {
+			for (int item : items) {
+				benchmark::DoNotOptimize(manager.getPrefixTree(item));
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * items.size());
+	}
+
+	static void getConditionalTree(benchmark::State& state) {
+		const FPTreeManager<int>& manager = getPrunedManager(MICRO_DATASET);
+		const vector<int> items = manager.headerTable.getItems();
+		for (auto _ : state) {
+			// The segments of the header chain are tasks of the enclosing team
+			#pragma omp parallel shared(manager, items) default(none)
+			#pragma omp single
+			for (int item : items) {
+				benchmark::DoNotOptimize(manager.getConditionalTree(item));
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * items.size());
+	}
+
+	static void recomputeSupport(benchmark::State& state) {
+		const FPTreeManager<int>& manager = getPrunedManager(MICRO_DATASET);
+		const vector<int> items = manager.headerTable.getItems();
+		for (auto _ : state) {
+			state.PauseTiming();
+			vector<unique_ptr<FPTreeManager<int>>> prefixManagers;
+			for (int item : items) {
+				prefixManagers.push_back(manager.getPrefixTree(item));
+			}
+			state.ResumeTiming();
+			for (size_t i = 0; i < items.size(); i++) {
+				benchmark::DoNotOptimize(FrequentItemsets<int>::recomputeSupport(items[i], prefixManagers[i]->headerTable, prefixManagers[i]->supportCount));
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * items.size());
+	}
+
+	static void pruneInfrequent(benchmark::State& state) {
+		const FPTreeManager<int>& manager = getManager(MICRO_DATASET);
+		for (auto _ : state) {
+			state.PauseTiming();
+			FPTreeManager<int> copy(manager);
+			state.ResumeTiming();
+			copy.pruneInfrequent();
+			state.PauseTiming();
+			// The destruction of the tree must not be measured
+			{ FPTreeManager<int> discarded(move(copy)); }
+			state.ResumeTiming();
+		}
+	}
+
+	static void mergeChildren(benchmark::State& state) {
+		const FPTreeManager<int>& manager = getPrunedManager(MICRO_DATASET);
+		// Removing the most frequent item merges the children of every one of its nodes with the ones of the root
+		int mostFrequent = manager.headerTable.getItems().front();
+		for (int item : manager.headerTable.getItems()) {
+			if (manager.headerTable.getTotalFrequency(item) > manager.headerTable.getTotalFrequency(mostFrequent)) {
+				mostFrequent = item;
+			}
+		}
+		for (auto _ : state) {
+			state.PauseTiming();
+			FPTreeManager<int> copy(manager);
+			state.ResumeTiming();
+			copy.removeItem(mostFrequent);
+			state.PauseTiming();
+			{ FPTreeManager<int> discarded(move(copy)); }
+			state.ResumeTiming();
+		}
+	}
+
+	static void increaseFrequency(benchmark::State& state) {
+		const int itemCount = state.range(0);
+		HeaderTable<int> headerTable;
+		for (int item = 0; item < itemCount; item++) {
+			headerTable.addNode(make_shared<FPTreeNode<int>>(item, nullptr));
+		}
+		mt19937 generator(42);
+		uniform_int_distribution<int> distribution(0, itemCount - 1);
+		vector<int> items(1 << 16);
+		for (int& item : items) {
+			item = distribution(generator);
+		}
+		for (auto _ : state) {
+			for (int item : items) {
+				benchmark::DoNotOptimize(headerTable.increaseFrequency(item, 1));
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * items.size());
+	}
+
+	static void readTransactions(benchmark::State& state, const string& dataset) {
+		for (auto _ : state) {
+			FileOrderedReader reader(getPath(dataset));
+			while (!reader.isEOF()) {
+				benchmark::DoNotOptimize(reader.getNextOrderedTransaction());
+			}
+		}
+		state.SetBytesProcessed(state.iterations() * filesystem::file_size(getPath(dataset)));
+	}
+
+	static void mine(benchmark::State& state, const string& dataset, const double supportFraction, const int nThreads) {
+		FrequentPatternMiner<int> miner(nThreads);
+		int count = 0;
+		for (auto _ : state) {
+			FileOrderedReader reader(getPath(dataset));
+			count = miner.mine(reader, supportFraction, [](const list<int>&, const int) { });
+		}
+		state.counters["itemsets"] = count;
+	}
+};
+
+// Supports used for the end-to-end runs, datasets not listed here are mined with the default ones
+static const map<string, vector<double>> SUPPORTS = {
+		{"chess.dat", {0.8, 0.7}},
+		{"mushroom.dat", {0.3, 0.2}},
+		{"retail.dat", {0.02, 0.01}}
+};
+static const vector<double> DEFAULT_SUPPORTS = {0.5, 0.25};
+
+int main(int argc, char* argv[]) {
+	omp_set_nested(true);
+	Params::nThreads = omp_get_max_threads();
+	benchmark::RegisterBenchmark("FPTreeNode::addSequence", Benchmarks::addSequence)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark("FPTreeManager::getPrefixTree", Benchmarks::getPrefixTree)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark("FPTreeManager::getConditionalTree", Benchmarks::getConditionalTree)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark("FrequentItemsets::recomputeSupport", Benchmarks::recomputeSupport)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark("FPTreeManager::pruneInfrequent", Benchmarks::pruneInfrequent)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark("FPTreeManager::mergeChildren", Benchmarks::mergeChildren)->Unit(benchmark::kMillisecond);
+	benchmark::RegisterBenchmark("HeaderTable::increaseFrequency", Benchmarks::increaseFrequency)->Arg(128)->Arg(16384);
+	// End-to-end runs over every dataset, with one thread and with all of them
+	vector<string> datasets;
+	for (const filesystem::directory_entry& entry : filesystem::directory_iterator(DATASET_DIRECTORY)) {
+		if (entry.path().extension() == ".dat") {
+			datasets.push_back(entry.path().filename());
+		}
+	}
+	sort(datasets.begin(), datasets.end());
+	vector<int> threadCounts = {1};
+	if (omp_get_max_threads() > 1) {
+		threadCounts.push_back(omp_get_max_threads());
+	}
+	for (const string& dataset : datasets) {
+		benchmark::RegisterBenchmark(("FileOrderedReader/" + dataset).c_str(), Benchmarks::readTransactions, dataset)->Unit(benchmark::kMillisecond);
+	}
+	for (const string& dataset : datasets) {
+		const vector<double>& supports = SUPPORTS.contains(dataset) ? SUPPORTS.at(dataset) : DEFAULT_SUPPORTS;
+		for (double supportFraction : supports) {
+			for (int nThreads : threadCounts) {
+				ostringstream name;
+				name << "Mine/" << dataset << "/support:" << supportFraction * 100 << "%/threads:" << nThreads;
+				benchmark::RegisterBenchmark(name.str().c_str(), Benchmarks::mine, dataset, supportFraction, nThreads)->Unit(benchmark::kMillisecond)->UseRealTime();
+			}
+		}
+	}
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+		return 1;
+	}
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include "QuestGenerator.h"
+
+using namespace std;
+
+QuestGenerator::QuestGenerator(const Parameters& parameters) : parameters(parameters) {
+	if (parameters.transactions < 0 || parameters.averageLength <= 0 || parameters.items <= 0 || parameters.patterns <= 0 ||
+	    parameters.averagePatternLength <= 0 || parameters.correlation < 0 || parameters.corruption < 0 || parameters.corruption > 1 ||
+	    parameters.skew < 0) {
+		throw invalid_argument("Invalid generator parameters");
+	}
+	vector<double> itemWeights(parameters.items);
+	for (int item = 0; item < parameters.items; item++) {
+		itemWeights[item] = pow(item + 1, -parameters.skew);
+	}
+	this->itemDistribution = AliasTable(itemWeights);
+	this->generatePatterns();
+}
+
+void QuestGenerator::write(FILE* output) const {
+	const long long blocks = (this->parameters.transactions + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	bool failed = false;
+	// Blocks are generated in parallel and written in order
+	#pragma omp parallel for ordered schedule(dynamic) shared(blocks, output, failed) default(none)
+	for (long long block = 0; block < blocks; block++) {
+		string buffer;
+		this->generateBlock(block, buffer);
+		#pragma omp ordered
+		failed = failed || fwrite(buffer.data(), 1, buffer.size(), output) != buffer.size();
+	}
+	if (failed || fflush(output) != 0) {
+		throw runtime_error("Cannot write the transactions");
+	}
+}
+
+void QuestGenerator::generatePatterns() {
+	Random random(this->parameters.seed);
+	this->patterns.resize(this->parameters.patterns);
+	vector<double> patternWeights(this->parameters.patterns);
+	for (int i = 0; i < this->parameters.patterns; i++) {
+		Pattern& pattern = this->patterns[i];
+		const int length = min(max(random.poisson(this->parameters.averagePatternLength), 1), this->parameters.items);
+		if (i > 0) {
+			// A fraction of the items comes from the previous pattern, in order to model the correlation among patterns
+			vector<int> previous = this->patterns[i - 1].items;
+			const int common = min((int) (min(random.exponential(this->parameters.correlation), 1.0) * length), (int) previous.size());
+			for (int j = 0; j < common; j++) {
+				swap(previous[j], previous[j + random.next() % (previous.size() - j)]);
+				pattern.items.push_back(previous[j]);
+			}
+		}
+		while ((int) pattern.items.size() < length) {
+			const int item = this->itemDistribution.pick(random);
+			if (find(pattern.items.cbegin(), pattern.items.cend(), item) == pattern.items.cend()) {
+				pattern.items.push_back(item);
+			}
+		}
+		pattern.corruption = min(max(random.normal(this->parameters.corruption, 0.1), 0.0), 1.0);
+		patternWeights[i] = random.exponential(1);
+	}
+	this->patternDistribution = AliasTable(patternWeights);
+}
+
+void QuestGenerator::generateBlock(const long long block, string& buffer) const {
+	// Every block has its own sequence, far apart from the ones of the pattern pool and of the other blocks
+	Random random(this->parameters.seed ^ ((uint64_t) (block + 1) * 0x9E3779B97F4A7C15ULL));
+	const long long end = min((block + 1) * BLOCK_SIZE, this->parameters.transactions);
+	vector<int> transaction, items;
+	int pending = -1;
+	char number[16];
+	for (long long t = block * BLOCK_SIZE; t < end; t++) {
+		const size_t length = max(random.poisson(this->parameters.averageLength), 1);
+		transaction.clear();
+		while (transaction.size() < length) {
+			const int p = pending >= 0 ? pending : this->patternDistribution.pick(random);
+			pending = -1;
+			const Pattern& pattern = this->patterns[p];
+			// Corrupt the pattern by dropping random items as long as a uniform draw stays below its corruption level, at least one item is kept
+			items = pattern.items;
+			while (items.size() > 1 && random.uniform() < pattern.corruption) {
+				swap(items[random.next() % items.size()], items.back());
+				items.pop_back();
+			}
+			if (!transaction.empty() && transaction.size() + items.size() > length && random.uniform() < 0.5) {
+				// Half of the times a pattern that does not fit is moved to the next transaction
+				pending = p;
+				break;
+			}
+			transaction.insert(transaction.end(), items.cbegin(), items.cend());
+		}
+		sort(transaction.begin(), transaction.end());
+		transaction.erase(unique(transaction.begin(), transaction.end()), transaction.end());
+		for (size_t i = 0; i < transaction.size(); i++) {
+			if (i > 0) {
+				buffer.push_back(' ');
+			}
+			buffer.append(number, to_chars(number, number + sizeof(number), transaction[i]).ptr);
+		}
+		buffer.push_back('\n');
+	}
+}
+
+QuestGenerator::AliasTable::AliasTable(const vector<double>& weights) : probabilities(weights.size()), aliases(weights.size()) {
+	// Vose's construction: every column is filled up to the average weight by one other outcome
+	double total = 0;
+	for (double weight : weights) {
+		total += weight;
+	}
+	vector<int> small, large;
+	for (size_t i = 0; i < weights.size(); i++) {
+		this->probabilities[i] = weights[i] * weights.size() / total;
+		(this->probabilities[i] < 1 ? small : large).push_back(i);
+	}
+	while (!small.empty() && !large.empty()) {
+		const int less = small.back(), more = large.back();
+		small.pop_back();
+		this->aliases[less] = more;
+		this->probabilities[more] -= 1 - this->probabilities[less];
+		if (this->probabilities[more] < 1) {
+			large.pop_back();
+			small.push_back(more);
+		}
+	}
+	// Rounding errors leave some columns almost full
+	for (int i : small) {
+		this->probabilities[i] = 1;
+	}
+	for (int i : large) {
+		this->probabilities[i] = 1;
+	}
+}
+
+int QuestGenerator::AliasTable::pick(Random& random) const {
+	const int column = random.next() % this->probabilities.size();
+	return random.uniform() < this->probabilities[column] ? column : this->aliases[column];
+}
+
+QuestGenerator::Random::Random(uint64_t seed) {
+	// The state is initialized through splitmix64, as recommended by the authors of xoshiro
+	for (uint64_t& word : this->state) {
+		uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		word = z ^ (z >> 31);
+	}
+}
+
+uint64_t QuestGenerator::Random::next() {
+	const uint64_t result = rotl(this->state[1] * 5, 7) * 9;
+	const uint64_t t = this->state[1] << 17;
+	this->state[2] ^= this->state[0];
+	this->state[3] ^= this->state[1];
+	this->state[1] ^= this->state[2];
+	this->state[0] ^= this->state[3];
+	this->state[2] ^= t;
+	this->state[3] = rotl(this->state[3], 45);
+	return result;
+}
+
+double QuestGenerator::Random::uniform() {
+	// 53 random bits in [0, 1)
+	return (this->next() >> 11) * 0x1.0p-53;
+}
+
+double QuestGenerator::Random::exponential(const double mean) {
+	return -mean * log(1 - this->uniform());
+}
+
+double QuestGenerator::Random::normal(const double mean, const double deviation) {
+	// Box-Muller transform
+	const double u = 1 - this->uniform(), v = this->uniform();
+	return mean + deviation * sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+int QuestGenerator::Random::poisson(const double mean) {
+	if (mean > 64) {
+		// Normal approximation, the product of the uniforms would underflow
+		return max((int) lround(this->normal(mean, sqrt(mean))), 0);
+	}
+	// Knuth's algorithm
+	const double limit = exp(-mean);
+	int count = 0;
+	for (double product = this->uniform(); product > limit; product *= this->uniform()) {
+		count++;
+	}
+	return count;
+}
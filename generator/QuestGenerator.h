@@ -0,0 +1,81 @@
+#ifndef FREQUENTPATTERNMINING_QUESTGENERATOR_H
+#define FREQUENTPATTERNMINING_QUESTGENERATOR_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Synthetic transactions in the style of the IBM Quest generator by Agrawal and Srikant: a pool of potentially frequent
+ * patterns is generated first, each one sharing part of its items with the previous one, then every transaction is
+ * filled with corrupted copies of patterns picked according to their weights. Items are drawn from a Zipf
+ * distribution, a skew of 0 makes them uniform.
+ * Transactions are generated in fixed blocks, each one with its own random generator seeded from the seed and the
+ * block index, so that the blocks can be generated in parallel and the output depends only on the parameters.
+ */
+class QuestGenerator {
+public:
+	struct Parameters {
+		long long transactions;
+		double averageLength;
+		int items;
+		int patterns;
+		double averagePatternLength;
+		double correlation;
+		double corruption;
+		double skew;
+		uint64_t seed;
+	};
+
+	QuestGenerator(const Parameters& parameters);
+	void write(FILE* output) const;
+
+private:
+	/**
+	 * xoshiro256** generator, its sequence does not depend on the standard library implementation.
+	 */
+	class Random {
+	public:
+		Random(uint64_t seed);
+		uint64_t next();
+		double uniform();
+		double exponential(const double mean);
+		double normal(const double mean, const double deviation);
+		int poisson(const double mean);
+
+	private:
+		uint64_t state[4];
+	};
+
+	struct Pattern {
+		std::vector<int> items;
+		double corruption;
+	};
+
+	/**
+	 * Walker's alias method, draws from a discrete distribution in constant time.
+	 */
+	class AliasTable {
+	public:
+		AliasTable() = default;
+		AliasTable(const std::vector<double>& weights);
+		int pick(Random& random) const;
+
+	private:
+		std::vector<double> probabilities;
+		std::vector<int> aliases;
+	};
+
+	// Transactions of every block, a pattern that does not fit in a transaction can be carried only within its block
+	static constexpr long long BLOCK_SIZE = 1 << 16;
+	Parameters parameters;
+	std::vector<Pattern> patterns;
+	AliasTable patternDistribution;
+	AliasTable itemDistribution;
+
+	void generatePatterns();
+	void generateBlock(const long long block, std::string& buffer) const;
+};
+
+#endif //FREQUENTPATTERNMINING_QUESTGENERATOR_H
@@ -0,0 +1,65 @@
+#include <boost/program_options.hpp>
+#include <cstdio>
+#include <iostream>
+#include <omp.h>
+#include "QuestGenerator.h"
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+	QuestGenerator::Parameters parameters;
+	string outputFile;
+	int nThreads;
+	try {
+		boost::program_options::options_description desc("Allowed options");
+		desc.add_options()
+				("help,h", "Print program usage")
+				("transactions,n", boost::program_options::value<long long>(&parameters.transactions)->default_value(100000), "Number of transactions")
+				("length,l", boost::program_options::value<double>(&parameters.averageLength)->default_value(10), "Average number of items of a transaction")
+				("items,i", boost::program_options::value<int>(&parameters.items)->default_value(1000), "Number of distinct items")
+				("patterns,p", boost::program_options::value<int>(&parameters.patterns)->default_value(2000), "Number of potentially frequent patterns")
+				("patternLength,a", boost::program_options::value<double>(&parameters.averagePatternLength)->default_value(4), "Average number of items of a pattern")
+				("correlation,c", boost::program_options::value<double>(&parameters.correlation)->default_value(0.5), "Average fraction of the items of a pattern shared with the previous one")
+				("corruption,r", boost::program_options::value<double>(&parameters.corruption)->default_value(0.5), "Average probability of dropping one more item from a pattern inserted in a transaction")
+				("skew,k", boost::program_options::value<double>(&parameters.skew)->default_value(0), "Exponent of the Zipf distribution of the items, 0 for uniform items")
+				("seed,s", boost::program_options::value<uint64_t>(&parameters.seed)->default_value(1), "Seed of the random generator, the same parameters and seed always give the same output")
+				("output,f", boost::program_options::value<string>(&outputFile), "Output file of the new-line separated transactions, instead of the standard output")
+				("threads,t",
+						boost::program_options::value<int>(&nThreads)->default_value(0)->notifier([](int value) {
+							if (value < 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "nThreads",
+																															 to_string(value));
+							}
+						}
+					),
+					"Number of threads to use, use 0 to use as many as the amount of cores"
+				);
+		boost::program_options::variables_map vm;
+		boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+		if (vm.count("help")) {
+			cout << desc << endl;
+			return 1;
+		}
+		boost::program_options::notify(vm);
+	} catch (exception &e) {
+		cerr << e.what() << endl;
+		return -1;
+	}
+	if (nThreads > 0) {
+		omp_set_num_threads(nThreads);
+	}
+	FILE* output = outputFile.empty() ? stdout : fopen(outputFile.c_str(), "w");
+	if (!output) {
+		cerr << "Cannot open the output file " << outputFile << endl;
+		return -1;
+	}
+	try {
+		QuestGenerator generator(parameters);
+		generator.write(output);
+	} catch (exception &e) {
+		cerr << e.what() << endl;
+		return -1;
+	}
+	return output == stdout || fclose(output) == 0 ? 0 : -1;
+}
@@ -0,0 +1,113 @@
+#!/bin/bash
+# Mines a dataset in the given mode and checks that it finds the same itemsets, with the same supports, as plain FP-growth.
+# Usage: check-equivalence.sh <FrequentPatternMining binary> <dataset> <support %> <mode>
+set -o pipefail
+binary=$1
+dataset=$2
+support=$3
+mode=$4
+directory=$(mktemp -d)
+trap 'rm -rf "$directory"' EXIT
+
+# Itemsets of the last report, with their items sorted, one per line in a fixed order. A report usually starts with its
+# count, while the time budget prints it after the itemsets
+canonical() {
+	awk '
+		/Found [0-9]+ frequent itemsets/ { reset = 1; next }
+		/^[0-9]+( [0-9]+)* \([0-9]+\)$/ {
+			if (reset) { count = 0; reset = 0 }
+			n = NF - 1
+			for (i = 1; i <= n; i++) item[i] = $i + 0
+			for (i = 2; i <= n; i++) for (j = i; j > 1 && item[j - 1] > item[j]; j--) { swap = item[j]; item[j] = item[j - 1]; item[j - 1] = swap }
+			line = ""
+			for (i = 1; i <= n; i++) line = line item[i] " "
+			itemsets[++count] = line $NF
+		}
+		END { for (i = 1; i <= count; i++) print itemsets[i] }
+	' | LC_ALL=C sort
+}
+
+mine() {
+	"$binary" -p "$@" > "$directory/output" || { echo "Failed: $binary -p $*"; cat "$directory/output"; exit 1; }
+	canonical < "$directory/output"
+}
+
+reference=$dataset
+supports=("$support")
+referenceSupport=$support
+case $mode in
+	shards)
+		# The reports and the snapshot are only written by the coordinator
+		arguments=(-i "$dataset" --shards 3 --shardDirectory "$directory" --stats "$directory/stats.json" --memorySamples "$directory/samples"
+		           --writeSnapshot "$directory/snapshot") ;;
+	outOfCore)
+		# On mushroom at 20% the two biggest projected databases exceed the budget and are projected again
+		arguments=(-i "$dataset" --outOfCore --projectionDirectory "$directory" --memoryBudget 4) ;;
+	window)
+		# Three batches in a window of two, the first one is forgotten
+		transactions=$(wc -l < "$dataset")
+		batch=$(((transactions + 2) / 3))
+		tail -n $((transactions - batch)) "$dataset" > "$directory/window.dat"
+		reference=$directory/window.dat
+		arguments=(-i "$dataset" --window 2 --batchSize $batch) ;;
+	snapshot)
+		"$binary" -i "$dataset" -s "$support" -o --writeSnapshot "$directory/snapshot" > /dev/null || exit 1
+		arguments=(--snapshot "$directory/snapshot") ;;
+	sweep)
+		# The tree is mined with the lowest support and the last report, of a higher one, is filtered from its itemsets
+		referenceSupport=$(awk -v support="$support" 'BEGIN { print support * 2 }')
+		supports=("$support" "$referenceSupport")
+		arguments=(-i "$dataset") ;;
+	queries)
+		# The exact support of every itemset found is counted on the unpruned FP-Tree
+		mine -s "$support" -i "$dataset" | sed 's/ ([0-9]*)$//' > "$directory/queries" || exit 1
+		arguments=(-i "$dataset" --queries "$directory/queries") ;;
+	pseudoProjection)
+		arguments=(-i "$dataset" --pseudoProjection -t 2) ;;
+	materialized)
+		# Small projections become conditional FP-Trees, both single paths and branching ones
+		arguments=(-i "$dataset" --pseudoProjection --materializeThreshold 64 -t 2) ;;
+	segmented)
+		# The top-level conditional trees are built by several tasks, each one over a segment of the header chain
+		arguments=(-i "$dataset" -t 4 --parallelDelete) ;;
+	timeBudget)
+		# A budget never reached, the itemsets of every batch must add up to all of them
+		arguments=(-i "$dataset" --timeBudget 600000) ;;
+	lcm)
+		arguments=(-i "$dataset" --engine lcm -t 2) ;;
+	sample)
+		# With this seed no negative border itemset is frequent, hence the verified results are complete
+		arguments=(-i "$dataset" --sample 50 --seed 1) ;;
+	auto)
+		arguments=(-i "$dataset" --auto) ;;
+	autoRejected)
+		# The modes building and mining their trees with their own settings cannot be combined with the automatic ones
+		for option in --outOfCore "--timeBudget 100" "--shards 2" "--window 2" "--sample 50" "--writeSnapshot $directory/snapshot"; do
+			if "$binary" -i "$dataset" -s "$support" --auto $option > /dev/null 2>&1; then
+				echo "--auto was accepted together with $option"
+				exit 1
+			fi
+		done
+		echo "--auto was rejected together with every mode having its own settings"
+		exit 0 ;;
+	*)
+		echo "Unknown mode $mode"
+		exit 1 ;;
+esac
+
+expected=$(mine -s "$referenceSupport" -i "$reference") || { echo "$expected"; exit 1; }
+actual=$(mine -s "${supports[@]}" "${arguments[@]}") || { echo "$actual"; exit 1; }
+if [ -z "$expected" ]; then
+	echo "No itemsets found by plain FP-growth"
+	exit 1
+fi
+if [ "$expected" != "$actual" ]; then
+	echo "The $mode mode found $(echo "$actual" | wc -l) itemsets instead of $(echo "$expected" | wc -l), differences:"
+	diff <(echo "$expected") <(echo "$actual") | head -20
+	exit 1
+fi
+if [ "$mode" = shards ] && grep -l "Writing FP-Tree snapshot\|Peak FP-Tree footprint" "$directory"/shard-*.log; then
+	echo "The shard workers were given the reports or the snapshot of the coordinator"
+	exit 1
+fi
+echo "The $mode mode found the same $(echo "$expected" | wc -l) itemsets as plain FP-growth"
@@ -0,0 +1,32 @@
+#!/bin/bash
+# Checks that the generator writes the same transactions for the same seed whatever the number of threads, and
+# different ones for another seed.
+# Usage: check-generator.sh <FrequentPatternMiningGenerator binary>
+binary=$1
+directory=$(mktemp -d)
+trap 'rm -rf "$directory"' EXIT
+
+# More transactions than a block, so that several blocks are generated in parallel
+arguments=(--transactions 150000 --length 5 --items 500 --patterns 200 --skew 0.5)
+"$binary" "${arguments[@]}" --seed 7 --threads 1 --output "$directory/sequential.dat" || { echo "Failed: $binary ${arguments[*]} --seed 7 --threads 1"; exit 1; }
+"$binary" "${arguments[@]}" --seed 7 --threads 3 --output "$directory/parallel.dat" || { echo "Failed: $binary ${arguments[*]} --seed 7 --threads 3"; exit 1; }
+"$binary" "${arguments[@]}" --seed 8 --output "$directory/other.dat" || { echo "Failed: $binary ${arguments[*]} --seed 8"; exit 1; }
+transactions=$(grep -c '^[0-9]\+\( [0-9]\+\)*$' "$directory/sequential.dat")
+if [ "$transactions" -ne 150000 ] || [ "$(wc -l < "$directory/sequential.dat")" -ne 150000 ]; then
+	echo "Wrote $(wc -l < "$directory/sequential.dat") lines with $transactions transactions instead of 150000"
+	exit 1
+fi
+if ! cmp -s "$directory/sequential.dat" "$directory/parallel.dat"; then
+	echo "The same seed gave different transactions with 1 and 3 threads"
+	exit 1
+fi
+if cmp -s "$directory/sequential.dat" "$directory/other.dat"; then
+	echo "Different seeds gave the same transactions"
+	exit 1
+fi
+# A negative number of threads is rejected
+if "$binary" --transactions 1 --threads -1 > /dev/null 2>&1; then
+	echo "A negative number of threads was accepted"
+	exit 1
+fi
+echo "The same $transactions transactions are generated with 1 and 3 threads"
@@ -0,0 +1,35 @@
+#!/bin/bash
+# Mines a dataset with the memory summary and samples, and checks that they account for the FP-Trees built.
+# Usage: check-memory.sh <FrequentPatternMining binary> <dataset> <support %>
+binary=$1
+dataset=$2
+support=$3
+directory=$(mktemp -d)
+trap 'rm -rf "$directory"' EXIT
+
+"$binary" -i "$dataset" -s "$support" -o --memorySummary --memorySamples "$directory/samples" --sampleInterval 10 > "$directory/output" || { echo "Failed: $binary -i $dataset -s $support -o --memorySummary --memorySamples"; exit 1; }
+summary=$(grep "^Peak FP-Tree footprint: " "$directory/output")
+# Peak nodes overall and in the conditional trees
+read -r nodes conditionalNodes <<< "$(echo "$summary" | sed -n 's/^Peak FP-Tree footprint: \([0-9]*\) nodes .*, \([0-9]*\) nodes .* in conditional trees.*$/\1 \2/p')"
+if [ -z "$nodes" ] || [ "$nodes" -le 0 ] || [ "$conditionalNodes" -le 0 ] || [ "$conditionalNodes" -gt "$nodes" ]; then
+	echo "Unexpected memory summary: ${summary:-missing}"
+	exit 1
+fi
+samples=$(grep -c '^{"seconds": [0-9.e+-]*, "liveNodes": [0-9-]*, ' "$directory/samples")
+if [ "$samples" -eq 0 ] || [ "$samples" -ne "$(wc -l < "$directory/samples")" ]; then
+	echo "Unexpected memory samples:"
+	head -5 "$directory/samples"
+	exit 1
+fi
+# No sample can exceed the peak
+lastNodes=$(tail -1 "$directory/samples" | sed 's/^.*"liveNodes": \([0-9-]*\),.*$/\1/')
+if [ "$lastNodes" -gt "$nodes" ]; then
+	echo "The last sample has $lastNodes live nodes, the peak is $nodes"
+	exit 1
+fi
+# Without any report the nodes are not accounted
+if "$binary" -i "$dataset" -s "$support" -o | grep -q "^Peak FP-Tree footprint"; then
+	echo "The memory summary is printed without --memorySummary"
+	exit 1
+fi
+echo "Peak of $nodes nodes, $conditionalNodes in conditional trees, $samples samples"
@@ -0,0 +1,42 @@
+#!/bin/bash
+# Mines a dataset with --stats and checks that the JSON report has every phase and counts the work done.
+# Usage: check-statistics.sh <FrequentPatternMining binary> <dataset> <support %>
+binary=$1
+dataset=$2
+support=$3
+directory=$(mktemp -d)
+trap 'rm -rf "$directory"' EXIT
+
+"$binary" -i "$dataset" -s "$support" -o --stats "$directory/stats.json" > /dev/null || { echo "Failed: $binary -i $dataset -s $support -o --stats"; exit 1; }
+report=$directory/stats.json
+# Value of a numeric field of the report
+field() {
+	sed -n "s/^ *\"$1\": \([0-9.e+-]*\),\{0,1\}$/\1/p" "$report" | head -1
+}
+
+for phase in frequencyPass treeBuild initialPrune mining; do
+	if [ -z "$(field $phase)" ]; then
+		echo "The phase $phase is missing from the report:"
+		cat "$report"
+		exit 1
+	fi
+done
+for counter in nodesAllocated prefixTrees headerTableLocks nodeLocks; do
+	value=$(field $counter)
+	if [ -z "$value" ] || [ "$value" -le 0 ]; then
+		echo "The counter $counter is ${value:-missing} in the report:"
+		cat "$report"
+		exit 1
+	fi
+done
+if ! grep -q '"tasksPerDepth": \[[0-9]' "$report"; then
+	echo "No task is counted at any depth in the report:"
+	cat "$report"
+	exit 1
+fi
+if [ "$(tr -cd '{' < "$report" | wc -c)" -ne "$(tr -cd '}' < "$report" | wc -c)" ]; then
+	echo "The braces of the report are not balanced:"
+	cat "$report"
+	exit 1
+fi
+echo "The report has every phase and counter, $(field nodesAllocated) nodes allocated"
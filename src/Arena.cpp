@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cstdlib>
+#include "Arena.h"
+#include "MemoryAccounting.h"
+#include "Statistics.h"
+
+using namespace std;
+
+Arena::Arena(const int depth) : current(nullptr), depth(min(depth, MemoryAccounting::MAX_DEPTH - 1)), accountedNodes(0), accountedBytes(0) {
+	omp_init_lock(&this->lock);
+}
+
+Arena::~Arena() {
+	MemoryAccounting::releaseNodes(this->depth, this->accountedNodes.load(memory_order_relaxed), this->accountedBytes.load(memory_order_relaxed));
+	for (Block* block = this->current.load(); block;) {
+		Block* previous = block->previous;
+		if (block->size == BLOCK_SIZE && Arena::freeBlocks.blocks.size() < MAX_FREE_BLOCKS) {
+			Arena::freeBlocks.blocks.push_back(block);
+		} else {
+			free(block);
+		}
+		block = previous;
+	}
+	omp_destroy_lock(&this->lock);
+}
+
+void* Arena::allocate(size_t size) {
+	size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	while (true) {
+		Block* block = this->current.load(memory_order_acquire);
+		if (block) {
+			const size_t offset = block->used.fetch_add(size, memory_order_relaxed);
+			if (offset + size <= block->size) {
+				return reinterpret_cast<char*>(block) + HEADER_SIZE + offset;
+			}
+		}
+		// Only the first task finding the block full replaces it, the other ones retry on the new block
+		omp_set_lock(&this->lock);
+		if (this->current.load(memory_order_relaxed) == block) {
+			this->current.store(Arena::newBlock(size, block), memory_order_release);
+		}
+		omp_unset_lock(&this->lock);
+	}
+}
+
+int Arena::getDepth() const {
+	return this->depth;
+}
+
+/**
+ * Adds a node to the footprint accounted to the arena, which is released together with its blocks.
+ */
+void Arena::account(const long long bytes) {
+	this->accountedNodes.fetch_add(1, memory_order_relaxed);
+	this->accountedBytes.fetch_add(bytes, memory_order_relaxed);
+}
+
+Arena::Block* Arena::newBlock(const size_t size, Block* previous) {
+	Block* block;
+	if (size <= BLOCK_SIZE && !Arena::freeBlocks.blocks.empty()) {
+		block = Arena::freeBlocks.blocks.back();
+		Arena::freeBlocks.blocks.pop_back();
+	} else {
+		Statistics::increment(Statistics::ARENA_BLOCKS);
+		void* memory = malloc(HEADER_SIZE + max(size, BLOCK_SIZE));
+		if (!memory) {
+			throw bad_alloc();
+		}
+		block = new (memory) Block();
+		block->size = max(size, BLOCK_SIZE);
+	}
+	block->previous = previous;
+	block->used.store(0, memory_order_relaxed);
+	return block;
+}
+
+Arena::FreeBlocks::~FreeBlocks() {
+	for (Block* block : this->blocks) {
+		free(block);
+	}
+}
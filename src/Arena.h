@@ -0,0 +1,100 @@
+#ifndef FREQUENTPATTERNMINING_ARENA_H
+#define FREQUENTPATTERNMINING_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <omp.h>
+
+/**
+ * Region from which the nodes and the header table entries of a conditional FP-Tree are allocated. Memory is taken by
+ * bumping an offset in fixed size blocks and never given back one object at a time: the blocks are released only
+ * together with the arena, when the tree is destroyed, and kept by the releasing thread for the next arenas, so that the
+ * mining recursion hardly ever reaches the global allocator. The nodes are never destroyed, neither the ones removed
+ * while the tree is mined nor the ones left when it is dropped: everything they hold lives in the arena as well, hence
+ * their storage is simply reused, and the footprint accounted to them is released all at once with the blocks.
+ * Allocations are thread safe, since the top-level conditional trees are built by several tasks.
+ */
+class Arena {
+public:
+	static constexpr size_t BLOCK_SIZE = 64 << 10;
+	// Blocks kept by every thread for the next arenas, the other ones are returned to the global allocator
+	static constexpr size_t MAX_FREE_BLOCKS = 256;
+
+	explicit Arena(const int depth);
+	Arena(const Arena&) = delete;
+	~Arena();
+	void* allocate(size_t size);
+	int getDepth() const;
+	void account(const long long bytes);
+
+private:
+	struct Block {
+		Block* previous;
+		size_t size;
+		std::atomic<size_t> used;
+	};
+
+	struct FreeBlocks {
+		std::vector<Block*> blocks;
+		~FreeBlocks();
+	};
+
+	static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+	static constexpr size_t HEADER_SIZE = (sizeof(Block) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	inline static thread_local FreeBlocks freeBlocks;
+	std::atomic<Block*> current;
+	omp_lock_t lock;
+	// Recursion depth of the conditional tree, to which the memory accounting charges its nodes
+	const int depth;
+	std::atomic<long long> accountedNodes;
+	std::atomic<long long> accountedBytes;
+
+	static Block* newBlock(const size_t size, Block* previous);
+};
+
+/**
+ * Allocator of the containers of a conditional FP-Tree, taking their memory from its arena. Without an arena it falls
+ * back to the global allocator, as for the initial tree.
+ */
+template <typename U>
+class ArenaAllocator {
+public:
+	typedef U value_type;
+
+	ArenaAllocator(Arena* arena = nullptr) noexcept : arena(arena) { }
+
+	template <typename V>
+	ArenaAllocator(const ArenaAllocator<V>& allocator) noexcept : arena(allocator.getArena()) { }
+
+	U* allocate(const size_t n) {
+		return static_cast<U*>(this->arena ? this->arena->allocate(n * sizeof(U)) : ::operator new(n * sizeof(U)));
+	}
+
+	void deallocate(U* pointer, const size_t) noexcept {
+		// Arena memory is only given back with its blocks, the object has already been destroyed
+		if (!this->arena) {
+			::operator delete(pointer);
+		}
+	}
+
+	Arena* getArena() const noexcept {
+		return this->arena;
+	}
+
+	template <typename V>
+	bool operator==(const ArenaAllocator<V>& allocator) const noexcept {
+		return this->arena == allocator.getArena();
+	}
+
+	template <typename V>
+	bool operator!=(const ArenaAllocator<V>& allocator) const noexcept {
+		return this->arena != allocator.getArena();
+	}
+
+private:
+	Arena* arena;
+};
+
+#endif //FREQUENTPATTERNMINING_ARENA_H
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <vector>
+#include "DatasetProfile.h"
+#include "FrequentPatternMiner.h"
+
+using namespace std;
+
+DatasetProfile::DatasetProfile(const TransactionReader& reader, const double supportFraction) : transactionCount(reader.getTransactionCount()),
+                                                                                                itemCount(reader.getFrequencies().size()),
+                                                                                                supportCount(reader.getSupportCount(supportFraction)),
+                                                                                                occurrences(0),
+                                                                                                frequentItemCount(0),
+                                                                                                frequentOccurrences(0) {
+	vector<long> frequencies;
+	for (const auto& [item, frequency] : reader.getFrequencies()) {
+		this->occurrences += frequency;
+		if (frequency >= this->supportCount) {
+			this->frequentItemCount++;
+			this->frequentOccurrences += frequency;
+			frequencies.push_back(frequency);
+		}
+	}
+	// Gini coefficient over the frequencies in ascending order
+	sort(frequencies.begin(), frequencies.end());
+	double weightedSum = 0;
+	for (size_t i = 0; i < frequencies.size(); i++) {
+		weightedSum += (double) (i + 1) * frequencies[i];
+	}
+	this->skew = this->frequentOccurrences > 0 ? 2 * weightedSum / ((double) frequencies.size() * this->frequentOccurrences) - (frequencies.size() + 1.0) / frequencies.size() : 0;
+	this->averageLength = this->transactionCount > 0 ? (double) this->occurrences / this->transactionCount : 0;
+	this->density = this->itemCount > 0 ? this->averageLength / this->itemCount : 0;
+	this->frequentLength = this->transactionCount > 0 ? (double) this->frequentOccurrences / this->transactionCount : 0;
+	this->frequentDensity = this->frequentItemCount > 0 ? this->frequentLength / this->frequentItemCount : 0;
+}
+
+DatasetProfile::Strategy DatasetProfile::getStrategy(const int maxThreads, const long long memoryBudget) const {
+	// The array database holds every frequent occurrence, and its reduced copies at the first levels about as much again
+	const int itemBits = FrequentPatternMiner<int>::getItemBits(this->itemCount);
+	const long long databaseSize = 3 * (this->frequentOccurrences * itemBits / 8 + (long long) this->transactionCount * (sizeof(size_t) + sizeof(int)));
+	if (this->frequentDensity < DENSE_DENSITY) {
+		return this->getStrategy(maxThreads, Engine::LCM, "LCM engine, the frequent items are not dense enough for the FP-Tree to share most prefixes");
+	} else if (databaseSize > memoryBudget) {
+		return this->getStrategy(maxThreads, Engine::FP_GROWTH, "FP-growth engine, the array databases would take about " + to_string(databaseSize >> 20) + " MB while the dense FP-Tree compresses them");
+	}
+	return this->getStrategy(maxThreads, Engine::LCM, "LCM engine, the array databases fit in " + to_string(memoryBudget >> 20) + " MB and shrink at every level by merging the identical transactions");
+}
+
+DatasetProfile::Strategy DatasetProfile::getStrategy(const int maxThreads, const Engine engine) const {
+	return this->getStrategy(maxThreads, engine, string(engine == Engine::LCM ? "LCM" : "FP-growth") + " engine given explicitly");
+}
+
+DatasetProfile::Strategy DatasetProfile::getStrategy(const int maxThreads, const Engine engine, const string& reason) const {
+	Strategy strategy;
+	strategy.engine = engine;
+	strategy.reasons.push_back(reason);
+	// Walking the tree in place pays off once the paths are shared, the sparse trees are better copied
+	strategy.pseudoProjection = strategy.engine == Engine::FP_GROWTH && this->frequentDensity >= SPARSE_DENSITY;
+	if (strategy.engine == Engine::FP_GROWTH) {
+		strategy.reasons.push_back(string("pseudo-projection ") + (strategy.pseudoProjection ? "enabled" : "disabled"));
+	}
+	if (this->frequentOccurrences < SEQUENTIAL_OCCURRENCES) {
+		strategy.nThreads = 1;
+		strategy.reasons.push_back("1 thread, " + to_string(this->frequentOccurrences) + " frequent item occurrences do not pay for the tasks");
+	} else {
+		// The first level items are the tasks, each about as big as the frequency of its item: with a skew g the work is
+		// as unequal as if only a fraction 1 - g of them held all of it, more threads than those stay mostly idle
+		const size_t balancedTasks = ceil(this->frequentItemCount * (1 - this->skew));
+		strategy.nThreads = max<int>(1, min<size_t>(maxThreads, balancedTasks));
+		ostringstream skew;
+		skew << this->skew;
+		strategy.reasons.push_back(to_string(strategy.nThreads) + (strategy.nThreads > 1 ? " threads" : " thread") + " over " + to_string(this->frequentItemCount)
+		                           + " first level items with frequency skew " + skew.str() + ", as balanced as " + to_string(balancedTasks) + " equal tasks");
+	}
+	// Most of the initial FP-Tree is deleted by the first pruning when most occurrences are infrequent
+	strategy.parallelDelete = strategy.engine == Engine::FP_GROWTH && strategy.nThreads > 1 && this->frequentOccurrences * 2 < this->occurrences;
+	if (strategy.engine == Engine::FP_GROWTH) {
+		strategy.reasons.push_back(string("parallel deletion ") + (strategy.parallelDelete ? "enabled" : "disabled"));
+	}
+	return strategy;
+}
+
+DatasetProfile::operator string() const {
+	ostringstream outStream;
+	outStream << "transactions: " << this->transactionCount
+	          << ", distinct items: " << this->itemCount
+	          << ", average length: " << this->averageLength
+	          << ", density: " << this->density
+	          << ", support count: " << this->supportCount
+	          << ", frequent items: " << this->frequentItemCount
+	          << ", average frequent length: " << this->frequentLength
+	          << ", frequent density: " << this->frequentDensity
+	          << ", frequent item skew: " << this->skew;
+	return outStream.str();
+}
+
+DatasetProfile::Strategy::operator string() const {
+	ostringstream outStream;
+	for (const string& reason : this->reasons) {
+		outStream << (outStream.tellp() > 0 ? "; " : "") << reason;
+	}
+	return outStream.str();
+}
@@ -0,0 +1,69 @@
+#ifndef FREQUENTPATTERNMINING_DATASETPROFILE_H
+#define FREQUENTPATTERNMINING_DATASETPROFILE_H
+
+#include <list>
+#include <ostream>
+#include <string>
+#include "Params.h"
+#include "TransactionReader.h"
+
+/**
+ * Shape of an input measured from the item frequencies of its reader, hence without any further pass over the
+ * transactions: how many items a transaction holds compared to the distinct ones, both before and after removing the
+ * infrequent items, and how unequal the frequencies of the frequent items are. The profile picks the settings of the run
+ * from the density, the size and the skew of the frequent items, so that the users do not need to know the dataset, and
+ * it is logged together with them to audit the choice.
+ */
+class DatasetProfile {
+public:
+	/**
+	 * Settings chosen for a profile, together with the reason of every choice.
+	 */
+	struct Strategy {
+		Engine engine;
+		bool pseudoProjection;
+		bool parallelDelete;
+		int nThreads;
+		std::list<std::string> reasons;
+
+		operator std::string() const;
+	};
+
+	// Inputs with fewer frequent item occurrences are mined faster by a single thread than by tasks
+	static constexpr long SEQUENTIAL_OCCURRENCES = 10000;
+	// Below this density of the frequent items the FP-Tree hardly shares any prefix and is better copied than walked
+	static constexpr double SPARSE_DENSITY = 0.1;
+	// Above this density of the frequent items the FP-Tree is much smaller than the array databases
+	static constexpr double DENSE_DENSITY = 0.6;
+
+	DatasetProfile(const TransactionReader& reader, const double supportFraction);
+	Strategy getStrategy(const int maxThreads, const long long memoryBudget) const;
+	Strategy getStrategy(const int maxThreads, const Engine engine) const;
+	operator std::string() const;
+
+private:
+	int transactionCount;
+	size_t itemCount;
+	double averageLength;
+	double density;
+	int supportCount;
+	long occurrences;
+	size_t frequentItemCount;
+	long frequentOccurrences;
+	double frequentLength;
+	double frequentDensity;
+	// Gini coefficient of the frequencies of the frequent items, 0 when they are all equal and close to 1 when a few items hold most occurrences
+	double skew;
+
+	Strategy getStrategy(const int maxThreads, const Engine engine, const std::string& reason) const;
+};
+
+inline std::ostream& operator << (std::ostream& out, const DatasetProfile& profile) {
+	return out << (std::string) profile;
+}
+
+inline std::ostream& operator << (std::ostream& out, const DatasetProfile::Strategy& strategy) {
+	return out << (std::string) strategy;
+}
+
+#endif //FREQUENTPATTERNMINING_DATASETPROFILE_H
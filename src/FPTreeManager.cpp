@@ -1,27 +1,49 @@
+#include <algorithm>
 #include <deque>
+#include <map>
+#include <unordered_map>
+#include <type_traits>
 #include <iostream>
 #include <iomanip>
 #include <cassert>
 #include "FPTreeManager.h"
 #include "Params.h"
+#include "Statistics.h"
 #include "Utils.cpp"
 
 using namespace std;
 
 template <typename T>
-FPTreeManager<T>::FPTreeManager(FileOrderedReader& reader, const double supportFraction) : FPTreeManager() {
-	this->generateFPTree(reader, supportFraction);
+FPTreeManager<T>::FPTreeManager(TransactionReader& reader, const double supportFraction, const MiningSettings& settings) : FPTreeManager() {
+	this->settings = settings;
+	const int itemsetCount = this->generateFPTree(reader);
+	// The reader counted the input itemsets while computing the frequencies, the same ones added to the tree
+	this->supportCount = reader.getSupportCount(supportFraction);
+	DEBUG(cout << "Total itemsets parsed: " << itemsetCount << ", support count: " << this->supportCount)
 }
 
 template <typename T>
-FPTreeManager<T>::FPTreeManager(const FPTreeManager<T>& manager) : supportCount(manager.supportCount) {
+FPTreeManager<T>::FPTreeManager(TransactionReader& reader, const int supportCount, const MiningSettings& settings) : FPTreeManager() {
+	this->settings = settings;
+	this->generateFPTree(reader);
+	this->supportCount = supportCount;
+}
+
+template <typename T>
+FPTreeManager<T>::FPTreeManager(const FPTreeManager<T>& manager) : supportCount(manager.supportCount), settings(manager.settings) {
 	DEBUG(cout << "Deep copy of FPTreeManager requested");
 	this->root = manager.root->deepCopy(nullptr, this->headerTable);
 }
 
 template <typename T>
-const shared_ptr<FPTreeNode<T>> FPTreeManager<T>::getRoot() const {
-	return this->root;
+FPTreeManager<T>::FPTreeManager(const FPTreeManager<T>& manager, const int supportCount) : FPTreeManager(manager) {
+	// The same unpruned tree can be mined with different supports by copying it
+	this->supportCount = supportCount;
+}
+
+template <typename T>
+const FPTreeNode<T>* FPTreeManager<T>::getRoot() const {
+	return this->root.get();
 }
 
 template <typename T>
@@ -34,17 +56,158 @@ const int FPTreeManager<T>::getSupportCount() const {
 	return this->supportCount;
 }
 
+template <typename T>
+const MiningSettings& FPTreeManager<T>::getSettings() const {
+	return this->settings;
+}
+
+template <typename T>
+int FPTreeManager<T>::getSupport(const list<T>& items) const {
+	return this->getSupports(vector<list<T>>(1, items)).front();
+}
+
+template <typename T>
+vector<int> FPTreeManager<T>::getSupports(const vector<list<T>>& itemsets) const {
+	vector<int> supports(itemsets.size(), 0);
+	// Queries are grouped by their least frequent item, so that its header chain is scanned once for all of them
+	map<T, vector<size_t>> groups;
+	for (size_t i = 0; i < itemsets.size(); i++) {
+		if (itemsets[i].empty()) {
+			// Every transaction contains the empty itemset
+			for (const shared_ptr<FPTreeNode<T>>& child : this->root->children) {
+				supports[i] += child->frequency;
+			}
+			continue;
+		}
+		// Paths are ordered by decreasing total frequency, hence the least frequent item is the deepest one of the itemset in every path
+		T last = itemsets[i].front();
+		int lastFrequency = this->headerTable.getTotalFrequency(last);
+		for (const T& item : itemsets[i]) {
+			const int frequency = this->headerTable.getTotalFrequency(item);
+			if (frequency < lastFrequency || (frequency == lastFrequency && item > last)) {
+				last = item;
+				lastFrequency = frequency;
+			}
+		}
+		if (lastFrequency > 0) {
+			groups[last].push_back(i);
+		}
+	}
+	vector<pair<T, vector<size_t>>> batches(groups.begin(), groups.end());
+	#pragma omp parallel shared(itemsets, supports, batches) default(none) if(!omp_in_parallel())
+	#pragma omp single
+	#pragma omp taskloop shared(itemsets, supports, batches) default(none)
+	for (size_t b = 0; b < batches.size(); b++) {
+		const T& last = batches[b].first;
+		const vector<size_t>& queries = batches[b].second;
+		// The other items of every query, sorted in order to be matched against the sorted ancestors of each node
+		vector<vector<T>> ancestors(queries.size());
+		bool onlySingletons = true;
+		for (size_t q = 0; q < queries.size(); q++) {
+			ancestors[q].assign(itemsets[queries[q]].cbegin(), itemsets[queries[q]].cend());
+			sort(ancestors[q].begin(), ancestors[q].end());
+			ancestors[q].erase(unique(ancestors[q].begin(), ancestors[q].end()), ancestors[q].end());
+			ancestors[q].erase(lower_bound(ancestors[q].begin(), ancestors[q].end(), last));
+			onlySingletons = onlySingletons && ancestors[q].empty();
+		}
+		vector<T> path;
+		for (shared_ptr<FPTreeNode<T>> node = this->headerTable.getNode(last); node; node = node->getNext().lock()) {
+			path.clear();
+			for (shared_ptr<FPTreeNode<T>> i = node->getParent().lock(); !onlySingletons && i->getFrequency() >= 0; i = i->getParent().lock()) {
+				path.push_back(i->getValue());
+			}
+			sort(path.begin(), path.end());
+			for (size_t q = 0; q < queries.size(); q++) {
+				if (includes(path.cbegin(), path.cend(), ancestors[q].cbegin(), ancestors[q].cend())) {
+					supports[queries[q]] += node->getFrequency();
+				}
+			}
+		}
+	}
+	return supports;
+}
+
+/**
+ * Returns the nodes of the tree from the child of the root downwards when the tree is a single path, otherwise nothing.
+ */
+template <typename T>
+vector<const FPTreeNode<T>*> FPTreeManager<T>::getSinglePath() const {
+	vector<const FPTreeNode<T>*> path;
+	for (const FPTreeNode<T>* node = this->root.get(); !node->children.empty(); node = node->children.cbegin()->get()) {
+		if (node->children.size() > 1) {
+			return vector<const FPTreeNode<T>*>();
+		}
+		path.push_back(node->children.cbegin()->get());
+	}
+	return path;
+}
+
 template <typename T>
 unique_ptr<FPTreeManager<T>> FPTreeManager<T>::getPrefixTree(const T& item) const {
-	unique_ptr<FPTreeManager<T>> newManager(new FPTreeManager<T>());
+	Statistics::increment(Statistics::PREFIX_TREES);
+	unique_ptr<FPTreeManager<T>> newManager(new FPTreeManager<T>(make_unique<Arena>(this->root->depth + 1)));
 	newManager->supportCount = this->supportCount;
-	newManager->root = this->root->getPrefixTree(nullptr, newManager->headerTable, item);
+	newManager->settings = this->settings;
+	newManager->root = this->root->getPrefixTree(nullptr, newManager->headerTable, item, newManager->arena.get());
+	return move(newManager);
+}
+
+template <typename T>
+unique_ptr<FPTreeManager<T>> FPTreeManager<T>::getConditionalTree(const T& item) const {
+	return this->getConditionalTree(item, this->supportCount);
+}
+
+template <typename T>
+unique_ptr<FPTreeManager<T>> FPTreeManager<T>::getConditionalTree(const T& item, const int supportCount) const {
+	// The tree is only read, hence an unpruned one can give the conditional trees of any support
+	Statistics::increment(Statistics::PREFIX_TREES);
+	unique_ptr<FPTreeManager<T>> newManager(new FPTreeManager<T>(make_unique<Arena>(this->root->depth + 1)));
+	newManager->supportCount = supportCount;
+	newManager->settings = this->settings;
+	vector<shared_ptr<FPTreeNode<T>>> nodes;
+	for (shared_ptr<FPTreeNode<T>> node = this->headerTable.getNode(item); node; node = node->getNext().lock()) {
+		nodes.push_back(node);
+	}
+	// The header chain is split in segments handled by different tasks, unless it is too short to be worth it
+	const size_t segmentCount = min((nodes.size() + SEGMENT_SIZE - 1) / SEGMENT_SIZE, (size_t) 4 * this->settings.nThreads);
+	vector<unordered_map<T, int>> segmentFrequencies(segmentCount);
+	#pragma omp taskloop shared(nodes, segmentCount, segmentFrequencies) default(none) grainsize(1) if(segmentCount > 1)
+	for (size_t segment = 0; segment < segmentCount; segment++) {
+		for (size_t i = segment * nodes.size() / segmentCount; i < (segment + 1) * nodes.size() / segmentCount; i++) {
+			for (shared_ptr<FPTreeNode<T>> j = nodes[i]->parent.lock(); j->frequency >= 0; j = j->parent.lock()) {
+				segmentFrequencies[segment][j->value] += nodes[i]->frequency;
+			}
+		}
+	}
+	unordered_map<T, int> frequencies;
+	for (const unordered_map<T, int>& partialFrequencies : segmentFrequencies) {
+		for (const auto& [ancestor, frequency] : partialFrequencies) {
+			frequencies[ancestor] += frequency;
+		}
+	}
+	// Only the frequent items of every path are inserted, hence the tree is already pruned
+	#pragma omp taskloop shared(nodes, segmentCount, frequencies, newManager, supportCount) default(none) grainsize(1) if(segmentCount > 1)
+	for (size_t segment = 0; segment < segmentCount; segment++) {
+		list<T> path;
+		for (size_t i = segment * nodes.size() / segmentCount; i < (segment + 1) * nodes.size() / segmentCount; i++) {
+			path.clear();
+			for (shared_ptr<FPTreeNode<T>> j = nodes[i]->parent.lock(); j->frequency >= 0; j = j->parent.lock()) {
+				if (frequencies.at(j->value) >= supportCount) {
+					path.push_front(j->value);
+				}
+			}
+			if (!path.empty()) {
+				newManager->addTransaction(path, nodes[i]->frequency);
+			}
+		}
+	}
 	return move(newManager);
 }
 
 template <typename T>
 void FPTreeManager<T>::pruneInfrequent() {
-	for (typename map<T, HeaderEntry<T>>::const_iterator it = this->headerTable.cbegin(); it != this->headerTable.cend(); it++) {
+	// With ranked items the biggest ones are the deepest in the tree, deleting them first leaves fewer children to merge
+	for (auto it = make_reverse_iterator(this->headerTable.cend()); it != make_reverse_iterator(this->headerTable.cbegin()); it++) {
 		if (it->second.getTotalFrequency() < this->supportCount) {
 			DEBUG(cout << "Deleting element " << *(it->second.getNode());)
 			this->deleteItem(it->second.getNode());
@@ -54,23 +217,50 @@ void FPTreeManager<T>::pruneInfrequent() {
 }
 
 template <typename T>
-shared_ptr<FPTreeNode<T>> FPTreeManager<T>::removeItem(const T& item) {
+void FPTreeManager<T>::removeItem(const T& item) {
 	shared_ptr<FPTreeNode<T>> first = this->headerTable.removeNode(item);
 	assert(first);
 	this->deleteItem(first);
-	return move(first);
+}
+
+template <typename T>
+shared_ptr<FPTreeNode<T>> FPTreeManager<T>::addTransaction(list<T>& items) {
+	return this->root->addSequence(items, this->headerTable, 1);
+}
+
+template <typename T>
+shared_ptr<FPTreeNode<T>> FPTreeManager<T>::addTransaction(list<T>& items, const int count) {
+	return this->root->addSequence(items, this->headerTable, count);
+}
+
+template <typename T>
+void FPTreeManager<T>::removeTransaction(shared_ptr<FPTreeNode<T>> node) {
+	// Walk from the last node of the transaction to the root decrementing the frequencies along the path
+	while (node->frequency >= 0) {
+		shared_ptr<FPTreeNode<T>> parent = node->parent.lock();
+		assert(node->frequency > 0);
+		node->frequency--;
+		this->headerTable.decreaseFrequency(node->value, 1);
+		if (node->frequency == 0) {
+			// No transaction passes through this node anymore, hence its descendants have already been removed
+			assert(node->children.empty());
+			this->headerTable.removeNode(node);
+			parent->children.erase(node);
+		}
+		node = move(parent);
+	}
 }
 
 template <typename T>
 FPTreeManager<T>::operator string() const {
 	ostringstream outStream;
-	deque<const FPTreeNode<int>*> nodes;
+	deque<const FPTreeNode<T>*> nodes;
 	deque<int> levels;
 	nodes.push_front(root.get());
 	levels.push_front(0);
 	while(!nodes.empty()) {
 		assert(nodes.size() == levels.size());
-		const FPTreeNode<int>* node = nodes.front();
+		const FPTreeNode<T>* node = nodes.front();
 		const int level = levels.front();
 		nodes.pop_front();
 		levels.pop_front();
@@ -81,7 +271,7 @@ FPTreeManager<T>::operator string() const {
 			outStream << setw(5) << "|-";
 		}
 		outStream << setfill('-') << setw(5) << *node << setfill(' ') << endl;
-		for (shared_ptr<FPTreeNode<int>> i : node->children) {
+		for (shared_ptr<FPTreeNode<T>> i : node->children) {
 			nodes.push_front(i.get());
 			levels.push_front(level + 1);
 		}
@@ -90,38 +280,49 @@ FPTreeManager<T>::operator string() const {
 }
 
 template <typename T>
-FPTreeManager<T>::FPTreeManager() : root(make_shared<FPTreeNode<T>>(-1, nullptr)) {
+FPTreeManager<T>::FPTreeManager() : FPTreeManager(nullptr) { }
+
+template <typename T>
+FPTreeManager<T>::FPTreeManager(unique_ptr<Arena> arena) : arena(move(arena)),
+                                                         root(FPTreeNode<T>::create(this->arena.get(), FPTreeNode<T>::ROOT_VALUE, nullptr, this->arena.get())),
+                                                         headerTable(this->arena.get()) {
 	// Marks the root node as such
 	this->root->frequency = -1;
 }
 
 template <typename T>
-void FPTreeManager<T>::generateFPTree(FileOrderedReader& reader, double supportFraction) {
+int FPTreeManager<T>::generateFPTree(TransactionReader& reader) {
+	Statistics::Phase phase("treeBuild");
 	int itemsetCount = 0;
 	list<T> items;
 	//HeaderTable<T>& headerTableAlias = this->headerTable;
-	#pragma omp parallel shared(reader, itemsetCount, items) default(none)
+	// When already running inside a parallel region (e.g. mining several projected databases at once) do not oversubscribe
+	#pragma omp parallel shared(reader, itemsetCount, items) default(none) if(!omp_in_parallel())
 	#pragma omp single
 	do {
 		#pragma omp task shared(reader, itemsetCount) firstprivate(items) default(none)
 		{
-			items = reader.getNextOrderedTransaction();
+			if constexpr (is_same_v<T, int>) {
+				items = reader.getNextOrderedTransaction();
+			} else {
+				// Readers give the items as int, narrower types are filled with the ranks given by a RankedReader
+				const list<int> transaction = reader.getNextOrderedTransaction();
+				items.assign(transaction.cbegin(), transaction.cend());
+			}
 			if (!items.empty()) {
-				this->root->addSequence(items, this->headerTable);
+				this->root->addSequence(items, this->headerTable, 1);
 				#pragma omp atomic
 				itemsetCount++;
 			}
 		}
 	} while(!reader.isEOF());
 	#pragma omp taskwait
-	// Knowing the number of the input itemsets it is possible to determine the required count to be frequent given the required supportFraction percentage
-	this->supportCount = itemsetCount * supportFraction;
-	DEBUG(cout << "Total itemsets parsed: " << itemsetCount << ", support count: " << this->supportCount)
+	return itemsetCount;
 }
 
 template <typename T>
 void FPTreeManager<T>::deleteItem(shared_ptr<FPTreeNode<T>> node) {
-	if (Params::parallelDelete) {
+	if (this->settings.parallelDelete) {
 		this->deleteItemParallel(node);
 	} else {
 		this->deleteItemSequential(node);
@@ -137,7 +338,7 @@ void FPTreeManager<T>::deleteItemParallel(shared_ptr<FPTreeNode<T>> node) {
 	//#pragma omp parallel for schedule(dynamic) shared(nodes, cout) default(none) if(Params::parallelDelete) //if(nodes.size() > 100) //num_threads(Params::nThreads)
 	//#pragma omp parallel shared(nodes, cout) default(none)
 	//#pragma omp single
-	#pragma omp taskloop shared(nodes, cout) default(none) if(Params::parallelDelete) //grainsize(1) //if(nodes.size() > 100)
+	#pragma omp taskloop shared(nodes, cout) default(none) if(this->settings.parallelDelete) //grainsize(1) //if(nodes.size() > 100)
 	for (typename vector<shared_ptr<FPTreeNode<T>>>::iterator it = nodes.begin(); it != nodes.end(); it++) {
 		shared_ptr<FPTreeNode<T>>& node = *it;
 		DEBUG(cout << "Removing item " << *node << " from:" << endl << (string) *this)
@@ -198,6 +399,7 @@ void FPTreeManager<T>::mergeChildren(shared_ptr<FPTreeNode<T>> node, shared_ptr<
 			// Transfer frequency from child to uncle
 			uncle->incrementFrequency(child->frequency);
 			child->frequency = 0;
+			Statistics::increment(Statistics::MERGES);
 			// Remove child from the Header Table and disconnect it from its next and previous
 			this->headerTable.removeNode(child);
 			assert(!uncle->previous.expired() || this->headerTable.getNode(uncle->value) == uncle);
@@ -1,9 +1,13 @@
 #ifndef FREQUENTPATTERNMINING_FPTREEMANAGER_H
 #define FREQUENTPATTERNMINING_FPTREEMANAGER_H
 
+#include <list>
 #include <memory>
-#include "FileOrderedReader.h"
+#include <vector>
+#include "Arena.h"
+#include "TransactionReader.h"
 #include "HeaderTable.h"
+#include "Params.h"
 
 template <typename T>
 class FPTreeNode;
@@ -11,29 +15,62 @@ class FPTreeNode;
 template <typename T>
 class FrequentItemsets;
 
+template <typename T>
+class SlidingWindow;
+
+template <typename T>
+class FPTreeSnapshot;
+
+template <typename T>
+class PseudoProjection;
+
+struct Benchmarks;
+
 template <typename T>
 class FPTreeManager {
+	friend Benchmarks;
 	friend FrequentItemsets<T>;
+	friend SlidingWindow<T>;
+	friend FPTreeSnapshot<T>;
+	friend PseudoProjection<T>;
 public:
-	FPTreeManager(FileOrderedReader& reader, const double supportFraction);
+	FPTreeManager(TransactionReader& reader, const double supportFraction, const MiningSettings& settings = MiningSettings());
+	FPTreeManager(TransactionReader& reader, const int supportCount, const MiningSettings& settings = MiningSettings());
 	FPTreeManager(const FPTreeManager<T>& manager);
+	FPTreeManager(const FPTreeManager<T>& manager, const int supportCount);
 	FPTreeManager(FPTreeManager<T>&& manager) = default;
-	~FPTreeManager() = default;
-	const std::shared_ptr<FPTreeNode<T>> getRoot() const;
+	const FPTreeNode<T>* getRoot() const;
 	const HeaderTable<T>& getHeaderTable() const;
 	const int getSupportCount() const;
+	const MiningSettings& getSettings() const;
+	int getSupport(const std::list<T>& items) const;
+	std::vector<int> getSupports(const std::vector<std::list<T>>& itemsets) const;
+	std::vector<const FPTreeNode<T>*> getSinglePath() const;
 	std::unique_ptr<FPTreeManager<T>> getPrefixTree(const T& item) const;
+	std::unique_ptr<FPTreeManager<T>> getConditionalTree(const T& item) const;
+	std::unique_ptr<FPTreeManager<T>> getConditionalTree(const T& item, const int supportCount) const;
 	void pruneInfrequent();
-	std::shared_ptr<FPTreeNode<T>> removeItem(const T& item);
+	void removeItem(const T& item);
+	std::shared_ptr<FPTreeNode<T>> addTransaction(std::list<T>& items);
+	std::shared_ptr<FPTreeNode<T>> addTransaction(std::list<T>& items, const int count);
+	void removeTransaction(std::shared_ptr<FPTreeNode<T>> node);
 	operator std::string() const;
 
 private:
+	// Header chain nodes handled by every task building a conditional tree
+	static constexpr size_t SEGMENT_SIZE = 1024;
+
+	// Conditional trees own the arena of their nodes, hence it is destroyed after them. Their nodes go away with it, so
+	// no pointer to them, owning or not, may outlive the manager
+	std::unique_ptr<Arena> arena;
 	std::shared_ptr<FPTreeNode<T>> root;
 	HeaderTable<T> headerTable;
 	int supportCount;
+	MiningSettings settings;
 
 	FPTreeManager();
-	void generateFPTree(FileOrderedReader& reader, double supportFraction);
+	FPTreeManager(std::unique_ptr<Arena> arena);
+	int generateFPTree(TransactionReader& reader);
 	void deleteItem(std::shared_ptr<FPTreeNode<T>> node);
 	void deleteItemParallel(std::shared_ptr<FPTreeNode<T>> node);
 	void deleteItemSequential(std::shared_ptr<FPTreeNode<T>> node);
@@ -41,10 +78,9 @@ private:
 };
 
 template class FPTreeManager<int>;
-//template class FPTreeManager<long>;
-//template class FPTreeManager<float>;
-//template class FPTreeManager<double>;
-//template class FPTreeManager<std::string>;
+template class FPTreeManager<uint16_t>;
+template class FPTreeManager<uint32_t>;
+template class FPTreeManager<uint64_t>;
 
 template <typename T>
 inline std::ostream& operator << (std::ostream& out, const FPTreeManager<T>& node) {
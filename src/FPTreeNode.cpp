@@ -1,24 +1,37 @@
+#include <algorithm>
 #include <memory>
 #include <iostream>
 #include <cassert>
 #include "FPTreeNode.h"
 #include "HeaderTable.h"
+#include "MemoryAccounting.h"
 #include "Params.h"
+#include "Statistics.h"
 
 using namespace std;
 
 template <typename T>
-FPTreeNode<T>::FPTreeNode(const T& value, shared_ptr<FPTreeNode<T>> parent) : frequency(0),
-                                                                              value(value),
-                                                                              parent(parent),
-                                                                              children(FPTreeNode<T>::nodeComparator)
+FPTreeNode<T>::FPTreeNode(const T& value, shared_ptr<FPTreeNode<T>> parent, Arena* arena) : frequency(0),
+                                                                                            value(value),
+                                                                                            parent(parent),
+                                                                                            children(FPTreeNode<T>::nodeComparator, arena),
+                                                                              depth(parent ? parent->depth : arena ? arena->getDepth() : 0)
 {
-	omp_init_lock(&this->lock);
+	Statistics::increment(Statistics::NODES_ALLOCATED);
+	if (MemoryAccounting::enabled) {
+		MemoryAccounting::allocateNode(this->depth, this->getFootprint());
+		if (arena) {
+			arena->account(this->getFootprint());
+		}
+	}
 }
 
 template <typename T>
 FPTreeNode<T>::~FPTreeNode() {
-	omp_destroy_lock(&this->lock);
+	// Only run for the nodes of the initial tree and of its copies, the ones of an arena are released with it
+	if (MemoryAccounting::enabled) {
+		MemoryAccounting::releaseNode(this->depth, this->getFootprint());
+	}
 }
 
 template <typename T>
@@ -75,32 +88,34 @@ void FPTreeNode<T>::setPrevious(weak_ptr<FPTreeNode<T>> previous) {
 }
 
 template<typename T>
-void FPTreeNode<T>::addSequence(list<T>& values, HeaderTable<T>& headerTable) {
+shared_ptr<FPTreeNode<T>> FPTreeNode<T>::addSequence(list<T>& values, HeaderTable<T>& headerTable, const int count) {
 	if (values.empty()) {
-		return;
+		// The last node of the path is returned so that the sequence can be later removed
+		return this->getptr();
 	}
 	const T value = values.front();
 	values.pop_front();
-	omp_set_lock(&this->lock);
+	Statistics::setLock(&this->lock, Statistics::NODE_LOCKS);
 	// Binary search among the children
-	typename set<shared_ptr<FPTreeNode<T>>>::iterator childrenIt = lower_bound(this->children.begin(),
+	typename decltype(this->children)::iterator childrenIt = lower_bound(this->children.begin(),
 																																						 this->children.end(),
 																																						 value,
-																																						 [](const shared_ptr<FPTreeNode<T>>& a, const int& b) { return a->getValue() < b; });
+																																						 [](const shared_ptr<FPTreeNode<T>>& a, const T& b) { return a->getValue() < b; });
 	if (childrenIt == this->children.cend() || (*childrenIt)->getValue() != value) {
 		// The iterator needs to point to the item that follows value in order to have an optimized insertion via hint
 		assert(childrenIt == this->children.cend() || (*childrenIt)->value > value);
 		// Need to create a new node
-		shared_ptr<FPTreeNode<T>> newNode = make_shared<FPTreeNode<T>>(value, this->getptr());
+		Arena* arena = this->getArena();
+		shared_ptr<FPTreeNode<T>> newNode = arena ? FPTreeNode<T>::create(arena, value, this->getptr(), arena) : make_shared<FPTreeNode<T>>(value, this->getptr());
 		//DEBUG(cout << "Create new node: " << *newNode;)
 		childrenIt = this->children.insert(childrenIt, move(newNode));
 		headerTable.addNode(*childrenIt);
 	}
-	omp_unset_lock(&this->lock);
+	this->lock.clear(memory_order_release);
 	// Add new item and/or update count in the header table
-	headerTable.increaseFrequency(value, 1);
-	(*childrenIt)->incrementFrequency();
-	(*childrenIt)->addSequence(values, headerTable);
+	headerTable.increaseFrequency(value, count);
+	(*childrenIt)->incrementFrequency(count);
+	return (*childrenIt)->addSequence(values, headerTable, count);
 }
 
 template <typename T>
@@ -123,10 +138,34 @@ FPTreeNode<T>::operator string() const {
 }
 
 template <typename T>
-FPTreeNode<T>::FPTreeNode(const FPTreeNode<T>& node) : value(node.value),
-                                                       frequency(node.frequency),
-                                                       children(FPTreeNode<T>::nodeComparator) {
+FPTreeNode<T>::FPTreeNode(const FPTreeNode<T>& node) : FPTreeNode(node, nullptr) { }
+
+template <typename T>
+FPTreeNode<T>::FPTreeNode(const FPTreeNode<T>& node, Arena* arena) : value(node.value),
+                                                                     frequency(node.frequency),
+                                                                     children(FPTreeNode<T>::nodeComparator, arena),
+                                                                     depth(arena ? arena->getDepth() : node.depth) {
 	// Children, Next and Previous shall be initialized by FPTreeNode::deepCopy or FPTreeNode::getPrefixTree to ensure that only one copy per node is made
+	Statistics::increment(Statistics::NODES_ALLOCATED);
+	if (MemoryAccounting::enabled) {
+		MemoryAccounting::allocateNode(this->depth, this->getFootprint());
+		if (arena) {
+			arena->account(this->getFootprint());
+		}
+	}
+}
+
+template <typename T>
+long long FPTreeNode<T>::getFootprint() const {
+	// The node with the virtual table pointer and the counters of its control block, and the red-black tree node holding it among the children of its parent
+	const long long footprint = sizeof(FPTreeNode<T>) + sizeof(void*) + 2 * sizeof(int) + 4 * sizeof(void*) + sizeof(shared_ptr<FPTreeNode<T>>);
+	// Outside of an arena the control block is the one of make_shared, next to the node, while the one of an arena node points to it and holds its allocator
+	return this->getArena() ? footprint + sizeof(FPTreeNode<T>*) + sizeof(ArenaAllocator<FPTreeNode<T>>) : footprint;
+}
+
+template <typename T>
+Arena* FPTreeNode<T>::getArena() const {
+	return this->children.get_allocator().getArena();
 }
 
 template <typename T>
@@ -148,13 +187,13 @@ shared_ptr<FPTreeNode<T>> FPTreeNode<T>::deepCopy(shared_ptr<FPTreeNode<T>> pare
 }
 
 template <typename T>
-shared_ptr<FPTreeNode<T>> FPTreeNode<T>::getPrefixTree(shared_ptr<FPTreeNode<T>> parent, HeaderTable<T>& newHeaderTable, const T& item) const {
+shared_ptr<FPTreeNode<T>> FPTreeNode<T>::getPrefixTree(shared_ptr<FPTreeNode<T>> parent, HeaderTable<T>& newHeaderTable, const T& item, Arena* arena) const {
 	if (this->children.empty() && this->value != item) {
 		// Base case to trim a branch when it is known that it does not contain the prefix item
 		return nullptr;
 	}
 	// Set value and frequency
-	shared_ptr<FPTreeNode<T>> newNode(new FPTreeNode<T>(*this));
+	shared_ptr<FPTreeNode<T>> newNode = FPTreeNode<T>::create(arena, *this, arena);
 	if (this->value != item && this->frequency >= 0) {
 		// We want to set the frequency only of the prefix that we are going to create since the other ones are going to be recomputed
 		newNode->frequency = 0;
@@ -171,7 +210,7 @@ shared_ptr<FPTreeNode<T>> FPTreeNode<T>::getPrefixTree(shared_ptr<FPTreeNode<T>>
 	if (this->value != item) {
 		// Create new children
 		for (shared_ptr<FPTreeNode<T>> child : this->children) {
-			shared_ptr<FPTreeNode<T>> newChild = child->getPrefixTree(newNode, newHeaderTable, item);
+			shared_ptr<FPTreeNode<T>> newChild = child->getPrefixTree(newNode, newHeaderTable, item, arena);
 			if (newChild) {
 				newNode->children.insert(move(newChild));
 			}
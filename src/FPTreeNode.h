@@ -1,19 +1,29 @@
 #ifndef FREQUENTPATTERNMINING_FPTREENODE_H
 #define FREQUENTPATTERNMINING_FPTREENODE_H
 
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <list>
 #include <set>
 #include <memory>
-#include <omp.h>
+#include "Arena.h"
 
 template <typename T> class HeaderTable;
 template <typename T> class FPTreeManager;
+template <typename T> class FPTreeSnapshot;
+template <typename T> class PseudoProjection;
 
 template<typename T>
 class FPTreeNode : public std::enable_shared_from_this<FPTreeNode<T>> {
 	friend class FPTreeManager<T>;
+	friend class FPTreeSnapshot<T>;
+	friend class PseudoProjection<T>;
 public:
-	FPTreeNode(const T& value, std::shared_ptr<FPTreeNode<T>> parent);
+	// Value of the root, which does not hold any item and is recognized by its negative frequency
+	static constexpr T ROOT_VALUE = std::numeric_limits<T>::max();
+
+	FPTreeNode(const T& value, std::shared_ptr<FPTreeNode<T>> parent, Arena* arena = nullptr);
 	FPTreeNode(FPTreeNode<T>&& node) = delete;
 	~FPTreeNode();
 	std::shared_ptr<FPTreeNode<T>> getptr();
@@ -26,7 +36,7 @@ public:
 	void incrementFrequency(const int addend);
 	void setNext(std::weak_ptr<FPTreeNode<T>> next);
 	void setPrevious(std::weak_ptr<FPTreeNode<T>> previous);
-	void addSequence(std::list<T>& values, HeaderTable<T>& headerTable);
+	std::shared_ptr<FPTreeNode<T>> addSequence(std::list<T>& values, HeaderTable<T>& headerTable, const int count);
 	std::shared_ptr<FPTreeNode<T>> getChildren(const T& item) const;
 	operator std::string() const;
 
@@ -37,19 +47,38 @@ private:
 	std::weak_ptr<FPTreeNode<T>> parent;
 	std::weak_ptr<FPTreeNode<T>> next;
 	std::weak_ptr<FPTreeNode<T>> previous;
-	std::set<std::shared_ptr<FPTreeNode<T>>, decltype(FPTreeNode<T>::nodeComparator)*> children;
-	omp_lock_t lock;
+	// Children are allocated from the arena of the tree, if any
+	std::set<std::shared_ptr<FPTreeNode<T>>, decltype(FPTreeNode<T>::nodeComparator)*, ArenaAllocator<std::shared_ptr<FPTreeNode<T>>>> children;
+	// Spin lock of the children, which needs no destruction unlike an OpenMP lock since arena nodes are never destroyed
+	std::atomic_flag lock;
+	// Recursion depth of the tree the node belongs to, used by the memory accounting
+	uint8_t depth;
 
 	FPTreeNode(const FPTreeNode<T>& node);
+	FPTreeNode(const FPTreeNode<T>& node, Arena* arena);
+	template <typename... Args>
+	static std::shared_ptr<FPTreeNode<T>> create(Arena* arena, Args&&... args);
+	long long getFootprint() const;
+	Arena* getArena() const;
 	std::shared_ptr<FPTreeNode<T>> deepCopy(std::shared_ptr<FPTreeNode<T>> parent, HeaderTable<T>& newHeaderTable) const;
-	std::shared_ptr<FPTreeNode<T>> getPrefixTree(std::shared_ptr<FPTreeNode<T>> parent, HeaderTable<T>& newHeaderTable, const T& item) const;
+	std::shared_ptr<FPTreeNode<T>> getPrefixTree(std::shared_ptr<FPTreeNode<T>> parent, HeaderTable<T>& newHeaderTable, const T& item, Arena* arena) const;
 };
 
+template <typename T>
+template <typename... Args>
+std::shared_ptr<FPTreeNode<T>> FPTreeNode<T>::create(Arena* arena, Args&&... args) {
+	if (!arena) {
+		return std::shared_ptr<FPTreeNode<T>>(new FPTreeNode<T>(std::forward<Args>(args)...));
+	}
+	// The node and its control block are released with the arena, hence nothing is run when the last owner goes away
+	FPTreeNode<T>* node = new (arena->allocate(sizeof(FPTreeNode<T>))) FPTreeNode<T>(std::forward<Args>(args)...);
+	return std::shared_ptr<FPTreeNode<T>>(node, [](FPTreeNode<T>*) { }, ArenaAllocator<FPTreeNode<T>>(arena));
+}
+
 template class FPTreeNode<int>;
-//template class FPTreeNode<long>;
-//template class FPTreeNode<float>;
-//template class FPTreeNode<double>;
-//template class FPTreeNode<std::string>;
+template class FPTreeNode<uint16_t>;
+template class FPTreeNode<uint32_t>;
+template class FPTreeNode<uint64_t>;
 
 template <typename T>
 inline std::ostream& operator << (std::ostream& out, const FPTreeNode<T>& node) {
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "FPTreeSnapshot.h"
+#include "Params.h"
+#include "Statistics.h"
+
+using namespace std;
+
+static size_t alignOffset(size_t offset) {
+	return (offset + 7) & ~(size_t) 7;
+}
+
+template <typename T>
+FPTreeSnapshot<T>::FPTreeSnapshot(string path) : data(MAP_FAILED), size(0) {
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw invalid_argument("Cannot open the snapshot file");
+	}
+	struct stat status;
+	if (fstat(fd, &status) == 0) {
+		this->size = status.st_size;
+		this->data = this->size >= sizeof(Header) ? mmap(nullptr, this->size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+	}
+	close(fd);
+	if (this->data == MAP_FAILED) {
+		throw invalid_argument("Cannot map the snapshot file");
+	}
+	const char* base = static_cast<const char*>(this->data);
+	this->header = reinterpret_cast<const Header*>(base);
+	if (memcmp(this->header->magic, MAGIC, sizeof(MAGIC)) != 0 || this->header->version != VERSION || this->header->itemSize != sizeof(T)) {
+		munmap(this->data, this->size);
+		throw invalid_argument("The snapshot file is not compatible with this version");
+	}
+	// Counts are compared with the room left in the file, so that a corrupt header cannot make the sizes overflow
+	const size_t entriesOffset = alignOffset(sizeof(Header));
+	const bool entriesFit = this->size >= entriesOffset && this->header->entryCount <= (this->size - entriesOffset) / sizeof(Entry);
+	const size_t nodesOffset = entriesFit ? alignOffset(entriesOffset + this->header->entryCount * sizeof(Entry)) : 0;
+	if (!entriesFit || this->size < nodesOffset || this->header->nodeCount > (this->size - nodesOffset) / sizeof(Node)) {
+		munmap(this->data, this->size);
+		throw invalid_argument("The snapshot file is truncated");
+	}
+	this->entries = reinterpret_cast<const Entry*>(base + entriesOffset);
+	this->nodes = reinterpret_cast<const Node*>(base + nodesOffset);
+	if (!this->isConsistent()) {
+		munmap(this->data, this->size);
+		throw invalid_argument("The snapshot file is corrupt");
+	}
+	DEBUG(cout << "Mapped snapshot with " << this->header->nodeCount << " nodes and " << this->header->entryCount << " items")
+}
+
+template <typename T>
+bool FPTreeSnapshot<T>::isConsistent() const {
+	// Every index is checked once here, so that mining never reads outside the mapping nor loops forever
+	const uint64_t nodeCount = this->header->nodeCount;
+	if (nodeCount == 0 || nodeCount >= NONE || this->nodes[0].parent != NONE) {
+		return false;
+	}
+	// Nodes are in depth-first order, hence every parent comes before its children and the paths reach the root
+	for (uint64_t i = 1; i < nodeCount; i++) {
+		if (this->nodes[i].parent >= i) {
+			return false;
+		}
+	}
+	// Chains only hold nodes of their item other than the root, and no node is reached twice
+	vector<bool> chained(nodeCount, false);
+	for (uint64_t i = 0; i < this->header->entryCount; i++) {
+		const Entry& entry = this->entries[i];
+		if (i > 0 && !(this->entries[i - 1].item < entry.item)) {
+			return false;
+		}
+		for (uint32_t j = entry.first; j != NONE; j = this->nodes[j].next) {
+			if (j == 0 || j >= nodeCount || chained[j] || this->nodes[j].item != entry.item) {
+				return false;
+			}
+			chained[j] = true;
+		}
+	}
+	return true;
+}
+
+template <typename T>
+FPTreeSnapshot<T>::~FPTreeSnapshot() {
+	munmap(this->data, this->size);
+}
+
+template <typename T>
+void FPTreeSnapshot<T>::write(const FPTreeManager<T>& manager, const int transactionCount, string path) {
+	vector<Node> nodes;
+	unordered_map<const FPTreeNode<T>*, uint32_t> indices;
+	// Depth-first visit, the parent of every node has already been assigned an index
+	vector<pair<const FPTreeNode<T>*, uint32_t>> pending = {{manager.getRoot(), NONE}};
+	while (!pending.empty()) {
+		const auto [node, parent] = pending.back();
+		pending.pop_back();
+		if (nodes.size() >= NONE) {
+			throw length_error("The FP-Tree is too big to be stored in a snapshot");
+		}
+		const uint32_t index = nodes.size();
+		nodes.push_back({node->value, node->frequency, parent, NONE});
+		indices.emplace(node, index);
+		for (auto it = node->children.crbegin(); it != node->children.crend(); it++) {
+			pending.emplace_back(it->get(), index);
+		}
+	}
+	vector<Entry> entries;
+	const HeaderTable<T>& headerTable = manager.getHeaderTable();
+	for (const T& item : headerTable.getItems()) {
+		shared_ptr<FPTreeNode<T>> node = headerTable.getNode(item);
+		entries.push_back({item, headerTable.getTotalFrequency(item), node ? indices.at(node.get()) : NONE});
+		for (shared_ptr<FPTreeNode<T>> next; node; node = move(next)) {
+			next = node->getNext().lock();
+			nodes[indices.at(node.get())].next = next ? indices.at(next.get()) : NONE;
+		}
+	}
+	Header header = {{}, VERSION, sizeof(T), entries.size(), nodes.size(), transactionCount, manager.getSupportCount()};
+	memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	const size_t entriesOffset = alignOffset(sizeof(Header));
+	const size_t nodesOffset = alignOffset(entriesOffset + entries.size() * sizeof(Entry));
+	// The snapshot is renamed only once complete, so processes mapping it never observe a partial file
+	const string temporaryPath = path + ".tmp." + to_string(getpid());
+	bool written;
+	{
+		ofstream output(temporaryPath, ios::binary | ios::trunc);
+		const char padding[8] = {};
+		output.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		output.write(padding, entriesOffset - sizeof(Header));
+		output.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+		output.write(padding, nodesOffset - entriesOffset - entries.size() * sizeof(Entry));
+		output.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(Node));
+		written = (bool) output.flush();
+	}
+	error_code error;
+	if (written) {
+		filesystem::rename(temporaryPath, path, error);
+	}
+	if (!written || error) {
+		// A partial file is never left behind
+		filesystem::remove(temporaryPath, error);
+		throw runtime_error("Cannot write the snapshot file " + path);
+	}
+	DEBUG(cout << "Written snapshot with " << nodes.size() << " nodes and " << entries.size() << " items")
+}
+
+template <typename T>
+int FPTreeSnapshot<T>::getTransactionCount() const {
+	return this->header->transactionCount;
+}
+
+template <typename T>
+int FPTreeSnapshot<T>::getSupportCount() const {
+	return this->header->supportCount;
+}
+
+template <typename T>
+vector<T> FPTreeSnapshot<T>::getItems(const int supportCount) const {
+	vector<T> result;
+	for (const Entry* entry = this->entries; entry != this->entries + this->header->entryCount; entry++) {
+		if (entry->totalFrequency >= supportCount) {
+			result.push_back(entry->item);
+		}
+	}
+	return result; // RVO
+}
+
+template <typename T>
+int FPTreeSnapshot<T>::getTotalFrequency(const T& item) const {
+	const Entry* entry = this->findEntry(item);
+	return entry ? entry->totalFrequency : 0;
+}
+
+template <typename T>
+unique_ptr<FPTreeManager<T>> FPTreeSnapshot<T>::getPrefixTree(const T& item, const int supportCount) const {
+	Statistics::increment(Statistics::PREFIX_TREES);
+	const Entry* entry = this->findEntry(item);
+	// The paths are inserted below the root, hence they belong to the first level of conditional trees as well
+	unique_ptr<FPTreeManager<T>> newManager(new FPTreeManager<T>(make_unique<Arena>(1)));
+	newManager->supportCount = supportCount;
+	if (!entry) {
+		return move(newManager);
+	}
+	// Every path from the root to a node of the item becomes a transaction weighted by the node frequency
+	for (uint32_t i = entry->first; i != NONE; i = this->nodes[i].next) {
+		list<T> path;
+		for (uint32_t j = this->nodes[i].parent; j != 0; j = this->nodes[j].parent) {
+			path.push_front(this->nodes[j].item);
+		}
+		if (!path.empty()) {
+			newManager->addTransaction(path, this->nodes[i].frequency);
+		}
+	}
+	return move(newManager);
+}
+
+template <typename T>
+const typename FPTreeSnapshot<T>::Entry* FPTreeSnapshot<T>::findEntry(const T& item) const {
+	// Entries are sorted by item as in the header table
+	const Entry* end = this->entries + this->header->entryCount;
+	const Entry* entry = lower_bound(this->entries, end, item, [](const Entry& entry, const T& item) { return entry.item < item; });
+	return entry != end && entry->item == item ? entry : nullptr;
+}
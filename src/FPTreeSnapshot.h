@@ -0,0 +1,73 @@
+#ifndef FREQUENTPATTERNMINING_FPTREESNAPSHOT_H
+#define FREQUENTPATTERNMINING_FPTREESNAPSHOT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FPTreeManager.h"
+
+/**
+ * Read-only on-disk image of a pruned FP-Tree and its header table, mapped in memory and mined without deserializing it.
+ * The file is made of a header followed by the header table entries and by the nodes, stored as flat arrays that
+ * refer to each other only by index, hence it is position independent and can be shared by several processes through
+ * the page cache. Node 0 is the root, nodes are stored in depth-first order so that every path is close in memory.
+ * Integers are stored with the byte order of the machine that wrote the snapshot.
+ */
+template <typename T>
+class FPTreeSnapshot {
+public:
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t itemSize;
+		uint64_t entryCount;
+		uint64_t nodeCount;
+		int64_t transactionCount;
+		int64_t supportCount;
+	};
+
+	struct Entry {
+		T item;
+		int32_t totalFrequency;
+		uint32_t first;
+	};
+
+	struct Node {
+		T item;
+		int32_t frequency;
+		uint32_t parent;
+		uint32_t next;
+	};
+
+	FPTreeSnapshot(std::string path);
+	FPTreeSnapshot(const FPTreeSnapshot<T>&) = delete;
+	~FPTreeSnapshot();
+	static void write(const FPTreeManager<T>& manager, const int transactionCount, std::string path);
+	int getTransactionCount() const;
+	int getSupportCount() const;
+	std::vector<T> getItems(const int supportCount) const;
+	int getTotalFrequency(const T& item) const;
+	std::unique_ptr<FPTreeManager<T>> getPrefixTree(const T& item, const int supportCount) const;
+
+private:
+	static constexpr char MAGIC[8] = {'F', 'P', 'T', 'S', 'N', 'A', 'P', '\0'};
+	void* data;
+	size_t size;
+	const Header* header;
+	const Entry* entries;
+	const Node* nodes;
+
+	bool isConsistent() const;
+	const Entry* findEntry(const T& item) const;
+};
+
+template class FPTreeSnapshot<int>;
+template class FPTreeSnapshot<uint16_t>;
+template class FPTreeSnapshot<uint32_t>;
+template class FPTreeSnapshot<uint64_t>;
+
+#endif //FREQUENTPATTERNMINING_FPTREESNAPSHOT_H
@@ -1,32 +1,53 @@
 #include <iostream>
+#include <iterator>
+#include <sstream>
 #include "FileOrderedReader.h"
 #include "Params.h"
+#include "Statistics.h"
 
 using namespace std;
 
-FileOrderedReader::FileOrderedReader(string input) : input(input) {
-	this->computeFrequencies();
+FileOrderedReader::FileOrderedReader(string input) : FileOrderedReader(input, true) { }
+
+FileOrderedReader::FileOrderedReader(string input, const bool computeFrequencies) : input(input) {
+	if (computeFrequencies) {
+		this->computeFrequencies();
+	} else if (!this->input.is_open()) {
+		throw invalid_argument("Cannot open the input file");
+	}
 }
 
 void FileOrderedReader::computeFrequencies() {
+	Statistics::Phase phase("frequencyPass");
 	if (!this->input.is_open()) {
 		throw invalid_argument("Cannot open the input file");
 	}
 	int item;
-	while (this->input >> item) {
-		map<int, int>::iterator lb = this->frequencies.lower_bound(item);
-		// Checks whether we are performing an add or an update
-		if (lb != this->frequencies.cend() && !(this->frequencies.key_comp()(item, lb->first))) {
-			lb->second++;
-		} else {
-			this->frequencies.insert(lb, map<int, int>::value_type(item, 1));
+	bool emptyLine = true;
+	for (int c = this->input.peek(); c != EOF; c = this->input.peek()) {
+		// Whitespaces are consumed here in order to count the non-empty lines, which are the transactions
+		if (isspace(c)) {
+			if (c == '\n' && !emptyLine) {
+				this->transactionCount++;
+				emptyLine = true;
+			}
+			this->input.get();
+			continue;
+		}
+		if (!(this->input >> item)) {
+			break;
 		}
+		emptyLine = false;
+		this->increaseFrequency(item);
+	}
+	if (!emptyLine) {
+		this->transactionCount++;
 	}
 	this->input.clear();
 	this->input.seekg(0);
 }
 
-list<int> FileOrderedReader::getNextOrderedTransaction() {
+list<int> FileOrderedReader::getNextTransaction() {
 	string line;
 	list<int> itemset;
 	bool ret;
@@ -35,14 +56,6 @@ list<int> FileOrderedReader::getNextOrderedTransaction() {
 	if (ret) {
 		istringstream iss(line);
 		itemset.assign(istream_iterator<int>(iss), istream_iterator<int>());
-		itemset.sort([&](int a, int b) { return this->frequencies.at(a) > this->frequencies.at(b); });
-		// We do not take into consideration duplicate elements
-		itemset.unique();
-		DEBUG(
-				ostringstream str;
-				copy(itemset.cbegin(), itemset.cend(), ostream_iterator<int>(str, " "));
-				cout << "Read ordered itemset: " << str.str();
-		)
 	}
 	return itemset; // RVO
 }
@@ -50,12 +63,3 @@ list<int> FileOrderedReader::getNextOrderedTransaction() {
 bool FileOrderedReader::isEOF() const {
 	return this->input.eof();
 }
-
-FileOrderedReader::operator string() const {
-	ostringstream outStream;
-	outStream << setw(10) << "Item" << " | " << setw(10) << "Frequency" << endl;
-	for (const pair<int, int>& p : this->frequencies) {
-		outStream << setw(10) << (string("'") + to_string(p.first) + string("'")) << " | " << setw(10) << p.second << endl;
-	}
-	return outStream.str();
-}
\ No newline at end of file
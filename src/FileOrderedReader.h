@@ -6,6 +6,7 @@
 #include <map>
 #include <string>
 #include <memory>
+#include "TransactionReader.h"
 
 /**
  * Reads a file composed by new-line separated transactions, determines the
@@ -14,25 +15,20 @@
  * This is going to be used in order to minimize the FP-tree size.
  * Warning: Multiple identical items in the same transaction will be simplified to one.
  */
-class FileOrderedReader {
+class FileOrderedReader : public TransactionReader {
 public:
 	FileOrderedReader(std::string input);
+	FileOrderedReader(std::string input, const bool computeFrequencies);
 	~FileOrderedReader() = default;
 	FileOrderedReader(FileOrderedReader&&) = default;
-	std::list<int> getNextOrderedTransaction();
-	bool isEOF() const;
-	operator std::string() const;
+	std::list<int> getNextTransaction() override;
+	bool isEOF() const override;
 
 private:
 	std::ifstream input;
-	std::map<int, int> frequencies;
 
 	FileOrderedReader(const FileOrderedReader&) = default;
 	void computeFrequencies();
 };
 
-inline std::ostream& operator << (std::ostream& out, const FileOrderedReader& fileOrderedReader) {
-	return out << (std::string) fileOrderedReader;
-}
-
 #endif //FREQUENTPATTERNMINING_FILE_ORDERED_READER_H
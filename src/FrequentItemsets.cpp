@@ -1,71 +1,341 @@
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include "FrequentItemsets.h"
 #include "Params.h"
+#include "Statistics.h"
 #include "Utils.cpp"
 
 using namespace std;
 
 template <typename T>
-FrequentItemsets<T>::FrequentItemsets(FPTreeManager<T>& manager) {
+FrequentItemsets<T>::FrequentItemsets(FPTreeManager<T>& manager) : FrequentItemsets(manager, Sink()) { }
+
+template <typename T>
+FrequentItemsets<T>::FrequentItemsets(FPTreeManager<T>& manager, const Sink& sink) : completeSupportCount(manager.supportCount), sink(sink) {
 	// Create threads here in order to keep under control their quantity
-	#pragma omp parallel shared(manager, cout) default(none)
+	#pragma omp parallel shared(manager, cout) default(none) num_threads(manager.settings.nThreads) if(!omp_in_parallel())
+	#pragma omp single
+	{
+		{
+			Statistics::Phase phase("initialPrune");
+			manager.pruneInfrequent();
+		}
+		Statistics::Phase phase("mining");
+		// The initial tree is only read while mining, hence it is not copied
+		if (manager.settings.pseudoProjection) {
+			this->frequentItemsets = this->computeFrequentItemsets(PseudoProjection<T>(manager), manager.headerTable.getItems());
+		} else {
+			this->frequentItemsets = this->computeFrequentItemsets(manager, 0);
+		}
+	}
+}
+
+template <typename T>
+FrequentItemsets<T>::FrequentItemsets(FPTreeManager<T>& manager, const vector<T>& prefixItems) : completeSupportCount(manager.supportCount) {
+	// Only the conditional subproblems of the given prefix items are mined, used to split the work among shards
+	#pragma omp parallel shared(manager, prefixItems, cout) default(none) num_threads(manager.settings.nThreads) if(!omp_in_parallel())
+	#pragma omp single
+	{
+		{
+			Statistics::Phase phase("initialPrune");
+			manager.pruneInfrequent();
+		}
+		Statistics::Phase phase("mining");
+		if (manager.settings.pseudoProjection) {
+			this->frequentItemsets = this->computeFrequentItemsets(PseudoProjection<T>(manager), prefixItems);
+		} else {
+			this->frequentItemsets = this->computeFrequentItemsets(manager, prefixItems, 0);
+		}
+	}
+}
+
+template <typename T>
+FrequentItemsets<T>::FrequentItemsets(const FPTreeSnapshot<T>& snapshot, const int supportCount) : completeSupportCount(supportCount) {
+	#pragma omp parallel shared(snapshot, supportCount, cout) default(none) if(!omp_in_parallel())
+	#pragma omp single
+	{
+		Statistics::Phase phase("mining");
+		vector<T> items = snapshot.getItems(supportCount);
+		Statistics::addTasks(0, items.size());
+		list<Itemset<T>> frequentItemsets;
+		#pragma omp declare reduction (merge : list<Itemset<T>> : omp_out.splice(omp_out.end(), omp_in))
+		#pragma omp taskloop shared(items, snapshot, supportCount, cout) default(none) reduction(merge: frequentItemsets)
+		for (typename vector<T>::iterator it = items.begin(); it != items.end(); it++) {
+			const T& item = *it;
+			frequentItemsets.push_back({{item}, snapshot.getTotalFrequency(item)});
+			// The prefix tree is built from the paths stored in the snapshot, hence the supports are already exact
+			list<Itemset<T>> partialFrequentItemsets = this->expandPrefix(item, snapshot.getPrefixTree(item, supportCount), 1);
+			frequentItemsets.splice(frequentItemsets.end(), partialFrequentItemsets);
+		}
+		this->frequentItemsets = move(frequentItemsets);
+	}
+}
+
+template <typename T>
+FrequentItemsets<T>::FrequentItemsets(const FPTreeManager<T>& manager, const int supportCount) : completeSupportCount(supportCount) {
+	// The tree is neither copied nor pruned, so that it can be mined concurrently with any support
+	#pragma omp parallel shared(manager, supportCount, cout) default(none) num_threads(manager.settings.nThreads) if(!omp_in_parallel())
 	#pragma omp single
 	{
-		manager.pruneInfrequent();
-		this->frequentItemsets = this->computeFrequentItemsets(make_unique<FPTreeManager<T>>(manager));
+		Statistics::Phase phase("mining");
+		vector<T> items;
+		for (const T& item : manager.headerTable.getItems()) {
+			// The entries of the items whose nodes have all been removed are left empty
+			const int frequency = manager.headerTable.getTotalFrequency(item);
+			if (frequency >= supportCount && frequency > 0) {
+				items.push_back(item);
+			}
+		}
+		Statistics::addTasks(0, items.size());
+		list<Itemset<T>> frequentItemsets;
+		#pragma omp declare reduction (merge : list<Itemset<T>> : omp_out.splice(omp_out.end(), omp_in))
+		#pragma omp taskloop shared(items, manager, supportCount, cout) default(none) reduction(merge: frequentItemsets)
+		for (typename vector<T>::iterator it = items.begin(); it != items.end(); it++) {
+			const T& item = *it;
+			frequentItemsets.push_back({{item}, manager.headerTable.getTotalFrequency(item)});
+			list<Itemset<T>> partialFrequentItemsets = this->expandPrefix(item, manager.getConditionalTree(item, supportCount), 1);
+			frequentItemsets.splice(frequentItemsets.end(), partialFrequentItemsets);
+		}
+		this->frequentItemsets = move(frequentItemsets);
+	}
+}
+
+template <typename T>
+FrequentItemsets<T>::FrequentItemsets(FPTreeManager<T>& manager, const chrono::steady_clock::time_point deadline, const ProgressCallback& callback) : deadline(deadline) {
+	#pragma omp parallel shared(manager, callback, cout) default(none) num_threads(manager.settings.nThreads) if(!omp_in_parallel())
+	#pragma omp single
+	{
+		{
+			Statistics::Phase phase("initialPrune");
+			manager.pruneInfrequent();
+		}
+		Statistics::Phase phase("mining");
+		// Every itemset not found yet contains a prefix item not expanded yet, hence its support is not bigger than the one of that item
+		vector<T> items = manager.headerTable.getItems();
+		vector<int> supports;
+		stable_sort(items.begin(), items.end(), [&manager](const T& a, const T& b) {
+			return manager.headerTable.getTotalFrequency(a) > manager.headerTable.getTotalFrequency(b);
+		});
+		for (const T& item : items) {
+			supports.push_back(manager.headerTable.getTotalFrequency(item));
+		}
+		supports.push_back(manager.supportCount - 1);
+		this->completeSupportCount = supports.front() + 1;
+		Statistics::addTasks(0, items.size());
+		// Batches of prefix items are expanded in parallel, their results are emitted once all of them are over
+		bool complete = true;
+		for (size_t begin = 0; begin < items.size() && !this->isExpired(); begin += manager.settings.nThreads) {
+			const size_t end = min(begin + manager.settings.nThreads, items.size());
+			vector<list<Itemset<T>>> results(end - begin);
+			vector<char> expanded(end - begin);
+			#pragma omp taskloop shared(manager, items, begin, end, results, expanded) default(none) grainsize(1)
+			for (size_t i = begin; i < end; i++) {
+				results[i - begin] = this->expandItem(manager, items[i], 0);
+				// An expansion that met the deadline may have skipped some prefixes
+				expanded[i - begin] = !this->expired;
+			}
+			list<Itemset<T>> batch;
+			for (size_t i = begin; i < end; i++) {
+				complete = complete && expanded[i - begin];
+				if (complete) {
+					this->completeSupportCount = supports[i + 1] + 1;
+				}
+				if (expanded[i - begin]) {
+					batch.splice(batch.end(), results[i - begin]);
+				}
+			}
+			callback(batch, this->completeSupportCount);
+			this->frequentItemsets.splice(this->frequentItemsets.end(), batch);
+		}
 	}
 }
 
 template <typename T>
-const list<list<T>>& FrequentItemsets<T>::getFrequentItemsets() const {
+const list<Itemset<T>>& FrequentItemsets<T>::getFrequentItemsets() const {
 	return this->frequentItemsets;
 }
 
 template <typename T>
-list<list<T>> FrequentItemsets<T>::computeFrequentItemsets(unique_ptr<FPTreeManager<T>> manager) {
-	DEBUG(cout << "Received FPTree manager: " << endl << (string) *manager)
-	list<list<T>> frequentItemsets;
-	const int supportCount = manager->getSupportCount();
+int FrequentItemsets<T>::getCompleteSupportCount() const {
+	return this->completeSupportCount;
+}
+
+template <typename T>
+void FrequentItemsets<T>::deliver(list<Itemset<T>>& itemsets, list<Itemset<T>>& frequentItemsets) {
+	if (!this->sink) {
+		frequentItemsets.splice(frequentItemsets.end(), itemsets);
+		return;
+	}
+	lock_guard<mutex> lock(this->sinkMutex);
+	this->sink(itemsets);
+}
+
+template <typename T>
+bool FrequentItemsets<T>::isExpired() {
+	if (this->expired.load(memory_order_relaxed)) {
+		return true;
+	}
+	if (this->deadline == chrono::steady_clock::time_point::max() || chrono::steady_clock::now() < this->deadline) {
+		return false;
+	}
+	this->expired = true;
+	return true;
+}
+
+template <typename T>
+list<Itemset<T>> FrequentItemsets<T>::computeFrequentItemsets(const FPTreeManager<T>& manager, const int depth) {
 	// Iterate over all the unique items that appeared in the itemset collection
-	vector<T> items = manager->headerTable.getItems();
+	return this->computeFrequentItemsets(manager, manager.headerTable.getItems(), depth);
+}
+
+template <typename T>
+list<Itemset<T>> FrequentItemsets<T>::computeFrequentItemsets(const FPTreeManager<T>& manager, const vector<T>& items, const int depth) {
+	DEBUG(cout << "Received FPTree manager: " << endl << (string) manager)
+	list<Itemset<T>> frequentItemsets;
 	if (items.empty()) {
 		// Prevents a segfault in the OpenMP handling of empty items
 		return frequentItemsets;
 	}
+	// Every prefix item is an iteration of the taskloop below
+	Statistics::addTasks(depth, items.size());
 	// Define custom reduction to move partial result to the final result, splice move data
-	#pragma omp declare reduction (merge : list<list<T>> : omp_out.splice(omp_out.end(), omp_in))
-	#pragma omp taskloop shared(items, manager, cout) default(none) reduction(merge: frequentItemsets) //grainsize(1)
+	#pragma omp declare reduction (merge : list<Itemset<T>> : omp_out.splice(omp_out.end(), omp_in))
+	#pragma omp taskloop shared(items, manager, depth, cout) default(none) reduction(merge: frequentItemsets) //grainsize(1)
 	//#pragma omp parallel for schedule(dynamic) shared(items, manager, cout) default(none) num_threads(nThreads) reduction(merge: frequentItemsets)
-	for (typename vector<T>::iterator it = items.begin(); it != items.end(); it++) {
-		const T& item = *it;
-		// All the remaining items in the header table are frequent
-		frequentItemsets.emplace_back((initializer_list<T>) {item});
-		DEBUG(cout << "Prefix element: " << item);
-		unique_ptr<FPTreeManager<T>> prefixManager = manager->getPrefixTree(item);
-		DEBUG(cout << "Raw Prefix tree: " << endl << *prefixManager);
-		// After recomputing support we will not need the chosen prefix's nodes anymore
-		if (!this->recomputeSupport(item, prefixManager->headerTable, prefixManager->supportCount)) {
-			DEBUG(cout << "No frequent item found, skipping prefix " << item);
+	for (typename vector<T>::const_iterator it = items.cbegin(); it != items.cend(); it++) {
+		if (this->isExpired()) {
+			// The iterations cannot be interrupted, hence the remaining ones are skipped
 			continue;
 		}
-		DEBUG(cout << "Recomputed support:" << endl << *prefixManager);
-		prefixManager->removeItem(item);
-		DEBUG(cout << "Removed prefix item " << item << endl << *prefixManager);
-		prefixManager->pruneInfrequent();
-		if (prefixManager->headerTable.empty()) {
-			DEBUG(cout << "Empty FPTree found for prefix " << item << ", skipping");
-			continue;
+		list<Itemset<T>> itemFrequentItemsets = this->expandItem(manager, *it, depth);
+		// Move partial result to the final result, the first level ones may be delivered right away
+		if (depth == 0) {
+			this->deliver(itemFrequentItemsets, frequentItemsets);
+		} else {
+			frequentItemsets.splice(frequentItemsets.end(), itemFrequentItemsets);
 		}
-		DEBUG(cout << "Prefix tree pruned with support recomputed: " << endl << *prefixManager);
-		list<list<T>> partialFrequentItemsets = this->computeFrequentItemsets(move(prefixManager));
-		// Prepend the current element to the results found
-		for (list<T>& partialItemset : partialFrequentItemsets) {
-			partialItemset.push_front(item);
+	}
+	return frequentItemsets;
+}
+
+template <typename T>
+list<Itemset<T>> FrequentItemsets<T>::expandItem(const FPTreeManager<T>& manager, const T& item, const int depth) {
+	// All the remaining items in the header table are frequent
+	list<Itemset<T>> frequentItemsets = {{{item}, manager.headerTable.getTotalFrequency(item)}};
+	DEBUG(cout << "Prefix element: " << item);
+	if (depth == 0) {
+		// The conditional trees of the initial tree are the biggest ones, each of them is built by several tasks
+		list<Itemset<T>> partialFrequentItemsets = this->expandPrefix(item, manager.getConditionalTree(item), depth + 1);
+		frequentItemsets.splice(frequentItemsets.end(), partialFrequentItemsets);
+		return frequentItemsets;
+	}
+	unique_ptr<FPTreeManager<T>> prefixManager = manager.getPrefixTree(item);
+	DEBUG(cout << "Raw Prefix tree: " << endl << *prefixManager);
+	// After recomputing support we will not need the chosen prefix's nodes anymore
+	if (!this->recomputeSupport(item, prefixManager->headerTable, prefixManager->supportCount)) {
+		DEBUG(cout << "No frequent item found, skipping prefix " << item);
+		return frequentItemsets;
+	}
+	DEBUG(cout << "Recomputed support:" << endl << *prefixManager);
+	prefixManager->removeItem(item);
+	DEBUG(cout << "Removed prefix item " << item << endl << *prefixManager);
+	list<Itemset<T>> partialFrequentItemsets = this->expandPrefix(item, move(prefixManager), depth + 1);
+	frequentItemsets.splice(frequentItemsets.end(), partialFrequentItemsets);
+	return frequentItemsets;
+}
+
+template <typename T>
+list<Itemset<T>> FrequentItemsets<T>::expandPrefix(const T& item, unique_ptr<FPTreeManager<T>> prefixManager, const int depth) {
+	prefixManager->pruneInfrequent();
+	if (prefixManager->headerTable.empty()) {
+		DEBUG(cout << "Empty FPTree found for prefix " << item << ", skipping");
+		return list<Itemset<T>>();
+	}
+	DEBUG(cout << "Prefix tree pruned with support recomputed: " << endl << *prefixManager);
+	list<Itemset<T>> partialFrequentItemsets = this->computeFrequentItemsets(*prefixManager, depth);
+	// Prepend the current element to the results found
+	for (Itemset<T>& partialItemset : partialFrequentItemsets) {
+		partialItemset.items.push_front(item);
+	}
+	return partialFrequentItemsets;
+}
+
+template <typename T>
+list<Itemset<T>> FrequentItemsets<T>::computeFrequentItemsets(const PseudoProjection<T>& base, const vector<T>& items) {
+	list<Itemset<T>> frequentItemsets;
+	if (items.empty()) {
+		// Prevents a segfault in the OpenMP handling of empty items
+		return frequentItemsets;
+	}
+	Statistics::addTasks(0, items.size());
+	#pragma omp declare reduction (merge : list<Itemset<T>> : omp_out.splice(omp_out.end(), omp_in))
+	#pragma omp taskloop shared(items, base) default(none) reduction(merge: frequentItemsets)
+	for (typename vector<T>::const_iterator it = items.cbegin(); it != items.cend(); it++) {
+		const T& item = *it;
+		const typename PseudoProjection<T>::Projection projection = base.getProjection(base.getIndex(item));
+		list<Itemset<T>> itemFrequentItemsets = this->expandProjection(item, base, projection, 1);
+		itemFrequentItemsets.push_front({{item}, base.getTotalFrequency(base.getIndex(item))});
+		this->deliver(itemFrequentItemsets, frequentItemsets);
+	}
+	return frequentItemsets;
+}
+
+template <typename T>
+list<Itemset<T>> FrequentItemsets<T>::expandProjection(const T& item, const PseudoProjection<T>& base, const typename PseudoProjection<T>::Projection& projection, const int depth) {
+	list<Itemset<T>> frequentItemsets;
+	if (projection.empty()) {
+		return frequentItemsets;
+	}
+	const typename PseudoProjection<T>::Frequencies frequencies = base.getFrequencies(projection);
+	if (frequencies.empty()) {
+		DEBUG(cout << "Empty projection found for prefix " << item << ", skipping");
+		return frequentItemsets;
+	}
+	if ((int) projection.size() <= base.getSettings().materializeThreshold) {
+		// Small enough to be worth building and mining the conditional FP-Tree
+		unique_ptr<FPTreeManager<T>> conditionalTree = base.getConditionalTree(projection, frequencies, depth);
+		// Paths sharing all their frequent items collapse into a single one, whose itemsets are simply enumerated
+		const vector<const FPTreeNode<T>*> path = conditionalTree->getSinglePath();
+		if (!path.empty()) {
+			return this->expandSinglePath(item, path);
 		}
-		// Move partial result to the final result
+		return this->expandPrefix(item, move(conditionalTree), depth);
+	}
+	Statistics::addTasks(depth, frequencies.size());
+	const vector<typename PseudoProjection<T>::Projection> projections = base.project(projection, frequencies);
+	#pragma omp declare reduction (merge : list<Itemset<T>> : omp_out.splice(omp_out.end(), omp_in))
+	#pragma omp taskloop shared(base, frequencies, projections, depth) default(none) reduction(merge: frequentItemsets)
+	for (size_t i = 0; i < frequencies.size(); i++) {
+		const T& prefixItem = base.getItem(frequencies[i].first);
+		frequentItemsets.push_back({{prefixItem}, frequencies[i].second});
+		list<Itemset<T>> partialFrequentItemsets = this->expandProjection(prefixItem, base, projections[i], depth + 1);
 		frequentItemsets.splice(frequentItemsets.end(), partialFrequentItemsets);
 	}
+	// Prepend the current element to the results found
+	for (Itemset<T>& itemset : frequentItemsets) {
+		itemset.items.push_front(item);
+	}
+	return frequentItemsets;
+}
+
+template <typename T>
+list<Itemset<T>> FrequentItemsets<T>::expandSinglePath(const T& item, const vector<const FPTreeNode<T>*>& path) {
+	list<Itemset<T>> frequentItemsets;
+	// Every combination of the nodes of the path is frequent, with the frequency of its deepest node
+	for (const FPTreeNode<T>* node : path) {
+		const size_t combinations = frequentItemsets.size();
+		typename list<Itemset<T>>::iterator it = frequentItemsets.begin();
+		for (size_t i = 0; i < combinations; i++, it++) {
+			Itemset<T>& itemset = frequentItemsets.emplace_back(*it);
+			itemset.items.push_back(node->getValue());
+			itemset.support = node->getFrequency();
+		}
+		frequentItemsets.push_back({{node->getValue()}, node->getFrequency()});
+	}
+	for (Itemset<T>& itemset : frequentItemsets) {
+		itemset.items.push_front(item);
+	}
 	return frequentItemsets;
 }
 
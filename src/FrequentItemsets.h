@@ -1,23 +1,62 @@
 #ifndef FREQUENTPATTERNMINING_FREQUENTITEMSETS_H
 #define FREQUENTPATTERNMINING_FREQUENTITEMSETS_H
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
 #include <omp.h>
 #include "FPTreeManager.h"
+#include "FPTreeSnapshot.h"
+#include "Itemset.h"
 #include "Params.h"
+#include "PseudoProjection.h"
+
+struct Benchmarks;
 
 template <typename T>
 class FrequentItemsets {
+	// The microbenchmarks measure the private mining steps too
+	friend Benchmarks;
 public:
+	typedef std::function<void(const std::list<Itemset<T>>& itemsets, const int completeSupportCount)> ProgressCallback;
+	// Receives the itemsets of every first level prefix item as soon as they are mined, one call at a time
+	typedef std::function<void(std::list<Itemset<T>>& itemsets)> Sink;
+
 	FrequentItemsets(FPTreeManager<T>& manager);
-	const std::list<std::list<T>>& getFrequentItemsets() const;
+	FrequentItemsets(FPTreeManager<T>& manager, const Sink& sink);
+	FrequentItemsets(FPTreeManager<T>& manager, const std::vector<T>& prefixItems);
+	FrequentItemsets(const FPTreeSnapshot<T>& snapshot, const int supportCount);
+	FrequentItemsets(const FPTreeManager<T>& manager, const int supportCount);
+	FrequentItemsets(FPTreeManager<T>& manager, const std::chrono::steady_clock::time_point deadline, const ProgressCallback& callback);
+	const std::list<Itemset<T>>& getFrequentItemsets() const;
+	int getCompleteSupportCount() const;
 	
 private:
-	std::list<std::list<T>> frequentItemsets;
+	std::list<Itemset<T>> frequentItemsets;
+	// Every itemset with at least this support has been found
+	int completeSupportCount;
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+	std::atomic<bool> expired = false;
+	// The itemsets given to the sink are not kept
+	Sink sink;
+	std::mutex sinkMutex;
 
-	std::list<std::list<T>> computeFrequentItemsets(std::unique_ptr<FPTreeManager<T>> manager);
-	bool recomputeSupport(const T& item, HeaderTable<T>& headerTable, const int supportCount);
+	std::list<Itemset<T>> computeFrequentItemsets(const FPTreeManager<T>& manager, const int depth);
+	std::list<Itemset<T>> computeFrequentItemsets(const FPTreeManager<T>& manager, const std::vector<T>& items, const int depth);
+	std::list<Itemset<T>> expandItem(const FPTreeManager<T>& manager, const T& item, const int depth);
+	std::list<Itemset<T>> expandPrefix(const T& item, std::unique_ptr<FPTreeManager<T>> prefixManager, const int depth);
+	std::list<Itemset<T>> computeFrequentItemsets(const PseudoProjection<T>& base, const std::vector<T>& items);
+	std::list<Itemset<T>> expandSinglePath(const T& item, const std::vector<const FPTreeNode<T>*>& path);
+	std::list<Itemset<T>> expandProjection(const T& item, const PseudoProjection<T>& base, const typename PseudoProjection<T>::Projection& projection, const int depth);
+	void deliver(std::list<Itemset<T>>& itemsets, std::list<Itemset<T>>& frequentItemsets);
+	bool isExpired();
+	static bool recomputeSupport(const T& item, HeaderTable<T>& headerTable, const int supportCount);
 };
 
 template class FrequentItemsets<int>;
+template class FrequentItemsets<uint16_t>;
+template class FrequentItemsets<uint32_t>;
+template class FrequentItemsets<uint64_t>;
 
 #endif //FREQUENTPATTERNMINING_FREQUENTITEMSETS_H
@@ -0,0 +1,94 @@
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include "FrequentPatternMiner.h"
+#include "FPTreeManager.h"
+#include "FrequentItemsets.h"
+#include "LCMMiner.h"
+#include "Params.h"
+
+using namespace std;
+
+template <typename T>
+FrequentPatternMiner<T>::FrequentPatternMiner(const int nThreads, const bool parallelDelete, const bool pseudoProjection, const Engine engine) : engine(engine) {
+	if (nThreads <= 0) {
+		throw invalid_argument("The number of threads must be positive");
+	}
+	this->settings.nThreads = nThreads;
+	this->settings.parallelDelete = parallelDelete;
+	this->settings.pseudoProjection = pseudoProjection;
+}
+
+template <typename T>
+int FrequentPatternMiner<T>::mine(TransactionReader& reader, const double supportFraction, const Callback& callback) const {
+	return this->mineItems(reader, supportFraction, [&callback](list<Itemset<T>>& itemsets) {
+		for (const Itemset<T>& itemset : itemsets) {
+			callback(itemset.items, itemset.support);
+		}
+	});
+}
+
+template <typename T>
+list<Itemset<T>> FrequentPatternMiner<T>::mine(TransactionReader& reader, const double supportFraction) const {
+	list<Itemset<T>> frequentItemsets;
+	this->mineItems(reader, supportFraction, [&frequentItemsets](list<Itemset<T>>& itemsets) {
+		frequentItemsets.splice(frequentItemsets.end(), itemsets);
+	});
+	return frequentItemsets;
+}
+
+template <typename T>
+int FrequentPatternMiner<T>::getItemBits(const size_t itemCount) {
+	// The biggest value of every type is left to the root of the trees
+	if (itemCount <= numeric_limits<uint16_t>::max()) {
+		return 16;
+	}
+	return itemCount <= numeric_limits<uint32_t>::max() ? 32 : 64;
+}
+
+template <typename T>
+int FrequentPatternMiner<T>::mineItems(TransactionReader& reader, const double supportFraction, const function<void(list<Itemset<T>>& itemsets)>& sink) const {
+	if (supportFraction <= 0 || supportFraction > 1) {
+		throw invalid_argument("The support fraction must be in (0, 1]");
+	}
+	RankedReader rankedReader(reader);
+	int count = 0;
+	// Ranks are mapped back to the items by the mining thread delivering them, straight into the itemsets handed to the sink
+	const auto getSink = [&rankedReader, &sink, &count](auto rankType) {
+		typedef decltype(rankType) U;
+		return [&rankedReader, &sink, &count](list<Itemset<U>>& rankFrequentItemsets) {
+			list<Itemset<T>> itemsets;
+			for (const Itemset<U>& rankItemset : rankFrequentItemsets) {
+				Itemset<T>& itemset = itemsets.emplace_back();
+				for (const U& rank : rankItemset.items) {
+					itemset.items.push_back(rankedReader.getItem(rank));
+				}
+				itemset.support = rankItemset.support;
+			}
+			count += itemsets.size();
+			sink(itemsets);
+		};
+	};
+	switch (FrequentPatternMiner<T>::getItemBits(rankedReader.getItemCount())) {
+		case 16:
+			this->mineRanks<uint16_t>(rankedReader, supportFraction, getSink(uint16_t()));
+			break;
+		case 32:
+			this->mineRanks<uint32_t>(rankedReader, supportFraction, getSink(uint32_t()));
+			break;
+		default:
+			this->mineRanks<uint64_t>(rankedReader, supportFraction, getSink(uint64_t()));
+	}
+	return count;
+}
+
+template <typename T>
+template <typename U>
+void FrequentPatternMiner<T>::mineRanks(RankedReader& reader, const double supportFraction, const function<void(list<Itemset<U>>& itemsets)>& sink) const {
+	if (this->engine == Engine::LCM) {
+		LCMMiner<U>(reader, supportFraction, this->settings).getFrequentItemsets(sink);
+		return;
+	}
+	FPTreeManager<U> manager(reader, supportFraction, this->settings);
+	FrequentItemsets<U>(manager, sink);
+}
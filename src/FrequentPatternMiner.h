@@ -0,0 +1,52 @@
+#ifndef FREQUENTPATTERNMINING_FREQUENTPATTERNMINER_H
+#define FREQUENTPATTERNMINING_FREQUENTPATTERNMINER_H
+
+#include <functional>
+#include <list>
+#include "Itemset.h"
+#include "MemoryOrderedReader.h"
+#include "Params.h"
+#include "RankedReader.h"
+#include "TransactionReader.h"
+
+/**
+ * Entry point of the mining engine for programs embedding it. The miner keeps the execution settings and hands them to
+ * the trees it builds, without touching the global ones, so that any number of instances can mine concurrently. Every
+ * run sizes its own team of threads, which OpenMP keeps alive for the next runs of the calling thread together with the
+ * arena blocks of every thread. Every frequent itemset is delivered to a callback together with its support instead of
+ * being printed, as soon as the subtree of its first level item is mined: the callback is invoked by one mining thread
+ * at a time. Items are mined as their frequency ranks, stored in the narrowest unsigned type that holds all of them, and
+ * mapped back to the original items in the results. The FP-growth engine and the array based LCM engine give the same
+ * itemsets.
+ */
+template <typename T>
+class FrequentPatternMiner {
+public:
+	typedef std::function<void(const std::list<T>& items, const int support)> Callback;
+
+	FrequentPatternMiner(const int nThreads, const bool parallelDelete = false, const bool pseudoProjection = false, const Engine engine = Engine::FP_GROWTH);
+	template <typename Iterator>
+	int mine(Iterator begin, Iterator end, const double supportFraction, const Callback& callback) const;
+	int mine(TransactionReader& reader, const double supportFraction, const Callback& callback) const;
+	std::list<Itemset<T>> mine(TransactionReader& reader, const double supportFraction) const;
+	static int getItemBits(const size_t itemCount);
+
+private:
+	MiningSettings settings;
+	Engine engine;
+
+	int mineItems(TransactionReader& reader, const double supportFraction, const std::function<void(std::list<Itemset<T>>& itemsets)>& sink) const;
+	template <typename U>
+	void mineRanks(RankedReader& reader, const double supportFraction, const std::function<void(std::list<Itemset<U>>& itemsets)>& sink) const;
+};
+
+template <typename T>
+template <typename Iterator>
+int FrequentPatternMiner<T>::mine(Iterator begin, Iterator end, const double supportFraction, const Callback& callback) const {
+	MemoryOrderedReader reader(begin, end);
+	return this->mine(reader, supportFraction, callback);
+}
+
+template class FrequentPatternMiner<int>;
+
+#endif //FREQUENTPATTERNMINING_FREQUENTPATTERNMINER_H
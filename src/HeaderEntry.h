@@ -21,5 +21,8 @@ private:
 };
 
 template struct HeaderEntry<int>;
+template struct HeaderEntry<uint16_t>;
+template struct HeaderEntry<uint32_t>;
+template struct HeaderEntry<uint64_t>;
 
 #endif //FREQUENTPATTERNMINING_HEADERENTRY_H
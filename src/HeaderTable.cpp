@@ -3,25 +3,38 @@
 #include <sstream>
 #include <iomanip>
 #include "HeaderTable.h"
+#include "MemoryAccounting.h"
 #include "Params.h"
+#include "Statistics.h"
 
 using namespace std;
 
 template <typename T>
-HeaderTable<T>::HeaderTable() {
+HeaderTable<T>::HeaderTable(Arena* arena) : headerTable(arena) {
 	omp_init_lock(&this->lock);
+	MemoryAccounting::addHeaderTables(1);
+}
+
+template <typename T>
+HeaderTable<T>::HeaderTable(const HeaderTable<T>& headerTable) : headerTable(headerTable.headerTable, ArenaAllocator<typename Entries::value_type>()) {
+	// Every copy needs its own lock, and it does not share the arena of the original
+	omp_init_lock(&this->lock);
+	MemoryAccounting::addHeaderTables(1);
+	MemoryAccounting::addHeaderEntries(this->headerTable.size());
 }
 
 template <typename T>
 HeaderTable<T>::~HeaderTable() {
 	omp_destroy_lock(&this->lock);
+	MemoryAccounting::addHeaderTables(-1);
+	MemoryAccounting::addHeaderEntries(-(long long) this->headerTable.size());
 }
 
 template <typename T>
 shared_ptr<FPTreeNode<T>> HeaderTable<T>::addNode(const shared_ptr<FPTreeNode<T>> node) {
 	shared_ptr<FPTreeNode<T>> previous;
-	omp_set_lock(&this->lock);
-	typename map<T, HeaderEntry<T>>::iterator lb = this->headerTable.lower_bound(node->getValue());
+	Statistics::setLock(&this->lock, Statistics::HEADER_TABLE_LOCKS);
+	typename Entries::iterator lb = this->headerTable.lower_bound(node->getValue());
 	// Checks whether we are performing an add or an update
 	if (lb != this->headerTable.cend() && !(this->headerTable.key_comp()(node->getValue(), lb->first))) {
 		lb->second.totalFrequency += node->getFrequency();
@@ -29,13 +42,16 @@ shared_ptr<FPTreeNode<T>> HeaderTable<T>::addNode(const shared_ptr<FPTreeNode<T>
 		// If true the node has already been inserted and its insertion would create a cycle
 		assert(lb->second.node != previous);
 		swap(lb->second.node, previous);
-		// Update next and previous fields in the nodes
-		previous->setPrevious(node);
+		// Update next and previous fields in the nodes, the entry can be empty if all of its nodes have been removed
+		if (previous) {
+			previous->setPrevious(node);
+		}
 		node->setPrevious(weak_ptr<FPTreeNode<T>>());
 		node->setNext(previous);
 	} else {
 		DEBUG(cout << "Inserted new element in header table: " << (string) *node;)
 		this->headerTable.try_emplace(lb, node->getValue(), node);
+		MemoryAccounting::addHeaderEntries(1);
 		node->setNext(weak_ptr<FPTreeNode<T>>());
 		node->setPrevious(weak_ptr<FPTreeNode<T>>());
 	}
@@ -45,28 +61,38 @@ shared_ptr<FPTreeNode<T>> HeaderTable<T>::addNode(const shared_ptr<FPTreeNode<T>
 
 template <typename T>
 shared_ptr<FPTreeNode<T>> HeaderTable<T>::getNode(const T& item) const {
-	omp_set_lock(const_cast<omp_lock_t*> (&this->lock));
-	typename map<T, HeaderEntry<T>>::const_iterator it = this->headerTable.find(item);
+	Statistics::setLock(const_cast<omp_lock_t*> (&this->lock), Statistics::HEADER_TABLE_LOCKS);
+	typename Entries::const_iterator it = this->headerTable.find(item);
 	shared_ptr<FPTreeNode<T>> node = it != this->headerTable.cend() ? it->second.node : nullptr;
 	omp_unset_lock(const_cast<omp_lock_t*> (&this->lock));
 	return move(node);
 }
 
+template <typename T>
+int HeaderTable<T>::getTotalFrequency(const T& item) const {
+	Statistics::setLock(const_cast<omp_lock_t*> (&this->lock), Statistics::HEADER_TABLE_LOCKS);
+	typename Entries::const_iterator it = this->headerTable.find(item);
+	int totalFrequency = it != this->headerTable.cend() ? it->second.totalFrequency : 0;
+	omp_unset_lock(const_cast<omp_lock_t*> (&this->lock));
+	return totalFrequency;
+}
+
 template <typename T>
 shared_ptr<FPTreeNode<T>> HeaderTable<T>::removeNode(const T& item) {
-	omp_set_lock(&this->lock);
-	typename map<T, HeaderEntry<T>>::iterator it = this->headerTable.find(item);
+	Statistics::setLock(&this->lock, Statistics::HEADER_TABLE_LOCKS);
+	typename Entries::iterator it = this->headerTable.find(item);
 	assert(it != this->headerTable.end());
 	shared_ptr<FPTreeNode<T>> entry = it->second.node;
 	this->headerTable.erase(it);
+	MemoryAccounting::addHeaderEntries(-1);
 	omp_unset_lock(&this->lock);
 	return move(entry);
 }
 
 template <typename T>
 bool HeaderTable<T>::removeNode(shared_ptr<FPTreeNode<T>> node) {
-	omp_set_lock(&this->lock);
-	typename map<T, HeaderEntry<T>>::iterator it = this->headerTable.find(node->getValue());
+	Statistics::setLock(&this->lock, Statistics::HEADER_TABLE_LOCKS);
+	typename Entries::iterator it = this->headerTable.find(node->getValue());
 	if (it == this->headerTable.end()) {
 		omp_unset_lock(&this->lock);
 		DEBUG(cout << "The node " << *node << " is already not present in the header table";)
@@ -93,8 +119,8 @@ bool HeaderTable<T>::removeNode(shared_ptr<FPTreeNode<T>> node) {
 
 template <typename T>
 shared_ptr<FPTreeNode<T>> HeaderTable<T>::resetEntry(const T& item) {
-	omp_set_lock(&this->lock);
-	typename map<T, HeaderEntry<T>>::iterator it = this->headerTable.find(item);
+	Statistics::setLock(&this->lock, Statistics::HEADER_TABLE_LOCKS);
+	typename Entries::iterator it = this->headerTable.find(item);
 	if (it == this->headerTable.end()) {
 		omp_unset_lock(&this->lock);
 		DEBUG(cout << "The item " << item << " is not in the header table";)
@@ -111,8 +137,8 @@ template <typename T>
 int HeaderTable<T>::increaseFrequency(const T& item, const int addend) {
 	// Addend can be 0 if a parent of this item has been chosen as prefix previously
 	assert(addend >= 0);
-	omp_set_lock(&this->lock);
-	typename map<T, HeaderEntry<T>>::iterator it = this->headerTable.find(item);
+	Statistics::setLock(&this->lock, Statistics::HEADER_TABLE_LOCKS);
+	typename Entries::iterator it = this->headerTable.find(item);
 	assert(it != this->headerTable.cend());
 	assert(it->second.totalFrequency >= 0);
 	int total = (it->second.totalFrequency += addend);
@@ -120,13 +146,26 @@ int HeaderTable<T>::increaseFrequency(const T& item, const int addend) {
 	return total;
 }
 
+template <typename T>
+int HeaderTable<T>::decreaseFrequency(const T& item, const int subtrahend) {
+	assert(subtrahend >= 0);
+	Statistics::setLock(&this->lock, Statistics::HEADER_TABLE_LOCKS);
+	typename Entries::iterator it = this->headerTable.find(item);
+	assert(it != this->headerTable.cend());
+	int total = (it->second.totalFrequency -= subtrahend);
+	assert(total >= 0);
+	omp_unset_lock(&this->lock);
+	return total;
+}
+
 template <typename T>
 void HeaderTable<T>::pruneInfrequent(int minSupportCount) {
 	DEBUG(cout << "Header table size before pruning: " << this->headerTable.size() << ", minimum support count: " << minSupportCount)
-	omp_set_lock(&this->lock);
-	erase_if(this->headerTable, [minSupportCount](const pair<T, HeaderEntry<T>>& i) {
+	Statistics::setLock(&this->lock, Statistics::HEADER_TABLE_LOCKS);
+	const size_t erased = erase_if(this->headerTable, [minSupportCount](const pair<T, HeaderEntry<T>>& i) {
 		return i.second.totalFrequency < minSupportCount;
 	});
+	MemoryAccounting::addHeaderEntries(-(long long) erased);
 	omp_unset_lock(&this->lock);
 	DEBUG(cout << "Header table size after pruning: " << this->headerTable.size())
 }
@@ -134,7 +173,7 @@ void HeaderTable<T>::pruneInfrequent(int minSupportCount) {
 template <typename T>
 vector<T> HeaderTable<T>::getItems() const {
 	vector<T> result;
-	omp_set_lock(const_cast<omp_lock_t*> (&this->lock));
+	Statistics::setLock(const_cast<omp_lock_t*> (&this->lock), Statistics::HEADER_TABLE_LOCKS);
 	for (const auto& [item, _] : this->headerTable) {
 		result.push_back(item);
 	}
@@ -143,12 +182,12 @@ vector<T> HeaderTable<T>::getItems() const {
 }
 
 template <typename T>
-typename map<T, HeaderEntry<T>>::const_iterator HeaderTable<T>::cbegin() {
+typename HeaderTable<T>::Entries::const_iterator HeaderTable<T>::cbegin() {
 	return this->headerTable.cbegin();
 }
 
 template <typename T>
-typename map<T, HeaderEntry<T>>::const_iterator HeaderTable<T>::cend() {
+typename HeaderTable<T>::Entries::const_iterator HeaderTable<T>::cend() {
 	return this->headerTable.cend();
 }
 
@@ -161,8 +200,8 @@ template <typename T>
 HeaderTable<T>::operator string() const {
 	ostringstream outStream;
 	outStream << setw(10) << "Key" << " | " << setw(38) << "Value(First - Total frequency)" << " | " << setw(15) << "Chain" << endl;
-	omp_set_lock(const_cast<omp_lock_t*> (&this->lock));
-	for (const typename map<T, HeaderEntry<T>>::value_type& entry : this->headerTable) {
+	Statistics::setLock(const_cast<omp_lock_t*> (&this->lock), Statistics::HEADER_TABLE_LOCKS);
+	for (const typename Entries::value_type& entry : this->headerTable) {
 		outStream << setw(10) << entry.first << " | ";
 		if (!entry.second.node) {
 			outStream << setw(37) << "NULL" << " |" << endl;
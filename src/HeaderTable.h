@@ -5,32 +5,42 @@
 #include <memory>
 #include <vector>
 #include "FPTreeNode.h"
+#include "Arena.h"
 #include "HeaderEntry.h"
 
 template <typename T>
 class HeaderTable {
 public:
-	HeaderTable();
+	// Entries are allocated from the arena of the tree, if any
+	typedef std::map<T, HeaderEntry<T>, std::less<T>, ArenaAllocator<std::pair<const T, HeaderEntry<T>>>> Entries;
+
+	HeaderTable(Arena* arena = nullptr);
+	HeaderTable(const HeaderTable<T>& headerTable);
 	~HeaderTable();
 	std::shared_ptr<FPTreeNode<T>> addNode(const std::shared_ptr<FPTreeNode<T>> node);
 	std::shared_ptr<FPTreeNode<T>> getNode(const T& item) const;
+	int getTotalFrequency(const T& item) const;
 	std::shared_ptr<FPTreeNode<T>> removeNode(const T& item);
 	bool removeNode(const std::shared_ptr<FPTreeNode<T>> node);
 	std::shared_ptr<FPTreeNode<T>> resetEntry(const T& item);
 	int increaseFrequency(const T& item, const int addend);
+	int decreaseFrequency(const T& item, const int subtrahend);
 	void pruneInfrequent(int minSupportCount);
 	std::vector<T> getItems() const;
-	typename std::map<T, HeaderEntry<T>>::const_iterator cbegin();
-	typename std::map<T, HeaderEntry<T>>::const_iterator cend();
+	typename Entries::const_iterator cbegin();
+	typename Entries::const_iterator cend();
 	bool empty() const;
 	operator std::string() const;
 
 private:
-	std::map<T, HeaderEntry<T>> headerTable;
+	Entries headerTable;
 	omp_lock_t lock;
 };
 
 template class HeaderTable<int>;
+template class HeaderTable<uint16_t>;
+template class HeaderTable<uint32_t>;
+template class HeaderTable<uint64_t>;
 
 template <typename T>
 inline std::ostream& operator << (std::ostream &out, const HeaderTable<T>& headerTable) {
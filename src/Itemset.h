@@ -0,0 +1,15 @@
+#ifndef FREQUENTPATTERNMINING_ITEMSET_H
+#define FREQUENTPATTERNMINING_ITEMSET_H
+
+#include <list>
+
+/**
+ * A frequent itemset together with its support count, i.e. the number of transactions that contain all of its items.
+ */
+template <typename T>
+struct Itemset {
+	std::list<T> items;
+	int support;
+};
+
+#endif //FREQUENTPATTERNMINING_ITEMSET_H
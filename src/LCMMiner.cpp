@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <omp.h>
+#include "LCMMiner.h"
+#include "Params.h"
+#include "Statistics.h"
+
+using namespace std;
+
+// Scratch space of the item counting, always left zeroed between two databases
+static thread_local vector<int> itemCounts;
+static thread_local vector<int> itemIndices;
+
+template <typename T>
+LCMMiner<T>::LCMMiner(TransactionReader& reader, const double supportFraction, const MiningSettings& settings) : nThreads(settings.nThreads) {
+	Statistics::Phase phase("databaseBuild");
+	int itemsetCount = 0;
+	vector<int> frequencies;
+	list<int> transaction;
+	do {
+		transaction = reader.getNextOrderedTransaction();
+		if (transaction.empty()) {
+			continue;
+		}
+		itemsetCount++;
+		for (const int item : transaction) {
+			if ((size_t) item >= frequencies.size()) {
+				frequencies.resize(item + 1, 0);
+			}
+			frequencies[item]++;
+			this->database.items.push_back(item);
+		}
+		this->database.offsets.push_back(this->database.items.size());
+		this->database.weights.push_back(1);
+	} while (!reader.isEOF());
+	// Same support count as the FP-Tree, so that both engines give the same itemsets
+	this->supportCount = reader.getSupportCount(supportFraction);
+	// Infrequent items are removed in place, so that the initial database only keeps the frequent ones
+	size_t size = 0;
+	size_t begin = 0;
+	for (size_t i = 0; i < this->database.weights.size(); i++) {
+		const size_t end = this->database.offsets[i + 1];
+		for (size_t j = begin; j < end; j++) {
+			if (frequencies[this->database.items[j]] >= this->supportCount) {
+				this->database.items[size++] = this->database.items[j];
+			}
+		}
+		begin = end;
+		this->database.offsets[i + 1] = size;
+	}
+	this->database.items.resize(size);
+	this->database.items.shrink_to_fit();
+	DEBUG(cout << "Array database with " << itemsetCount << " transactions and " << size << " frequent items, support count: " << this->supportCount)
+}
+
+template <typename T>
+list<Itemset<T>> LCMMiner<T>::getFrequentItemsets() const {
+	return this->mine(Sink());
+}
+
+template <typename T>
+void LCMMiner<T>::getFrequentItemsets(const Sink& sink) const {
+	this->mine(sink);
+}
+
+template <typename T>
+list<Itemset<T>> LCMMiner<T>::mine(const Sink& sink) const {
+	list<Itemset<T>> frequentItemsets;
+	mutex sinkMutex;
+	#pragma omp parallel shared(frequentItemsets, sink, sinkMutex) default(none) num_threads(this->nThreads) if(!omp_in_parallel())
+	#pragma omp single
+	{
+		Statistics::Phase phase("mining");
+		const Occurrences occurrences = this->deliver(this->database);
+		// Only the first level items are split among the tasks, every one of them mines its whole subtree
+		#pragma omp declare reduction (merge : list<Itemset<T>> : omp_out.splice(omp_out.end(), omp_in))
+		#pragma omp taskloop shared(occurrences, sink, sinkMutex) default(none) reduction(merge: frequentItemsets)
+		for (size_t i = 0; i < occurrences.items.size(); i++) {
+			vector<T> prefix(1, occurrences.items[i]);
+			list<Itemset<T>> itemFrequentItemsets = {{list<T>(prefix.cbegin(), prefix.cend()), occurrences.supports[i]}};
+			const Database database = this->project(occurrences, i);
+			if (!database.weights.empty()) {
+				this->expand(database, prefix, itemFrequentItemsets);
+			}
+			if (sink) {
+				lock_guard<mutex> lock(sinkMutex);
+				sink(itemFrequentItemsets);
+			} else {
+				frequentItemsets.splice(frequentItemsets.end(), itemFrequentItemsets);
+			}
+		}
+	}
+	return frequentItemsets;
+}
+
+template <typename T>
+int LCMMiner<T>::getSupportCount() const {
+	return this->supportCount;
+}
+
+template <typename T>
+typename LCMMiner<T>::Occurrences LCMMiner<T>::deliver(const Database& database) const {
+	Statistics::increment(Statistics::CONDITIONAL_DATABASES);
+	Occurrences occurrences;
+	vector<T> touched;
+	for (size_t i = 0; i < database.weights.size(); i++) {
+		for (size_t j = database.offsets[i]; j < database.offsets[i + 1]; j++) {
+			const T item = database.items[j];
+			if (item >= itemCounts.size()) {
+				itemCounts.resize(item + 1, 0);
+				itemIndices.resize(item + 1, 0);
+			}
+			if (itemCounts[item] == 0) {
+				touched.push_back(item);
+			}
+			itemCounts[item] += database.weights[i];
+		}
+	}
+	for (const T item : touched) {
+		if (itemCounts[item] >= this->supportCount) {
+			occurrences.items.push_back(item);
+		}
+	}
+	// Local indices follow the item order, as the transactions do
+	sort(occurrences.items.begin(), occurrences.items.end());
+	for (size_t i = 0; i < occurrences.items.size(); i++) {
+		occurrences.supports.push_back(itemCounts[occurrences.items[i]]);
+		itemIndices[occurrences.items[i]] = i + 1;
+	}
+	for (const T item : touched) {
+		itemCounts[item] = 0;
+	}
+
+	// Reduction: only the frequent items are kept and the transactions that become identical are merged
+	Database reduced;
+	vector<size_t> transactions;
+	for (size_t i = 0; i < database.weights.size(); i++) {
+		const size_t begin = reduced.items.size();
+		for (size_t j = database.offsets[i]; j < database.offsets[i + 1]; j++) {
+			if (itemIndices[database.items[j]] > 0) {
+				reduced.items.push_back(database.items[j]);
+			}
+		}
+		if (reduced.items.size() > begin) {
+			transactions.push_back(reduced.offsets.size() - 1);
+			reduced.offsets.push_back(reduced.items.size());
+			reduced.weights.push_back(database.weights[i]);
+		}
+	}
+	const auto range = [&reduced](const size_t transaction) {
+		return make_pair(reduced.items.cbegin() + reduced.offsets[transaction], reduced.items.cbegin() + reduced.offsets[transaction + 1]);
+	};
+	sort(transactions.begin(), transactions.end(), [&range](const size_t a, const size_t b) {
+		const auto [aBegin, aEnd] = range(a);
+		const auto [bBegin, bEnd] = range(b);
+		return lexicographical_compare(aBegin, aEnd, bBegin, bEnd);
+	});
+	vector<size_t> counts(occurrences.items.size() + 1, 0);
+	for (size_t i = 0; i < transactions.size(); i++) {
+		const auto [begin, end] = range(transactions[i]);
+		if (!occurrences.database.weights.empty()) {
+			const auto [lastBegin, lastEnd] = range(transactions[i - 1]);
+			if (equal(begin, end, lastBegin, lastEnd)) {
+				occurrences.database.weights.back() += reduced.weights[transactions[i]];
+				continue;
+			}
+		}
+		for (auto it = begin; it != end; it++) {
+			occurrences.database.items.push_back(*it);
+			counts[itemIndices[*it]]++;
+		}
+		occurrences.database.offsets.push_back(occurrences.database.items.size());
+		occurrences.database.weights.push_back(reduced.weights[transactions[i]]);
+	}
+
+	// Occurrence delivery: a single scan appends every transaction to the list of each one of its items
+	occurrences.occurrenceOffsets.assign(occurrences.items.size() + 1, 0);
+	for (size_t i = 0; i < occurrences.items.size(); i++) {
+		occurrences.occurrenceOffsets[i + 1] = occurrences.occurrenceOffsets[i] + counts[i + 1];
+	}
+	occurrences.occurrences.resize(occurrences.occurrenceOffsets.back());
+	vector<size_t> positions(occurrences.occurrenceOffsets.cbegin(), prev(occurrences.occurrenceOffsets.cend()));
+	for (size_t i = 0; i < occurrences.database.weights.size(); i++) {
+		for (size_t j = occurrences.database.offsets[i]; j < occurrences.database.offsets[i + 1]; j++) {
+			occurrences.occurrences[positions[itemIndices[occurrences.database.items[j]] - 1]++] = i;
+		}
+	}
+	for (const T item : occurrences.items) {
+		itemIndices[item] = 0;
+	}
+	return occurrences;
+}
+
+template <typename T>
+typename LCMMiner<T>::Database LCMMiner<T>::project(const Occurrences& occurrences, const size_t item) const {
+	// Conditional database of the item: its transactions truncated before it, the items after it are already mined
+	Database projected;
+	const Database& database = occurrences.database;
+	for (size_t i = occurrences.occurrenceOffsets[item]; i < occurrences.occurrenceOffsets[item + 1]; i++) {
+		const size_t transaction = occurrences.occurrences[i];
+		const auto begin = database.items.cbegin() + database.offsets[transaction];
+		const auto end = lower_bound(begin, database.items.cbegin() + database.offsets[transaction + 1], occurrences.items[item]);
+		if (begin != end) {
+			projected.items.insert(projected.items.end(), begin, end);
+			projected.offsets.push_back(projected.items.size());
+			projected.weights.push_back(database.weights[transaction]);
+		}
+	}
+	return projected;
+}
+
+template <typename T>
+void LCMMiner<T>::expand(const Database& database, vector<T>& prefix, list<Itemset<T>>& frequentItemsets) const {
+	const Occurrences occurrences = this->deliver(database);
+	for (size_t i = 0; i < occurrences.items.size(); i++) {
+		prefix.push_back(occurrences.items[i]);
+		frequentItemsets.push_back({list<T>(prefix.cbegin(), prefix.cend()), occurrences.supports[i]});
+		const Database projected = this->project(occurrences, i);
+		if (!projected.weights.empty()) {
+			this->expand(projected, prefix, frequentItemsets);
+		}
+		prefix.pop_back();
+	}
+}
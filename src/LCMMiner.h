@@ -0,0 +1,65 @@
+#ifndef FREQUENTPATTERNMINING_LCMMINER_H
+#define FREQUENTPATTERNMINING_LCMMINER_H
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <vector>
+#include "Itemset.h"
+#include "Params.h"
+#include "TransactionReader.h"
+
+/**
+ * Array based mining engine in the style of LCM, an alternative to the FP-Tree for sparse datasets with many items.
+ * The items are expected to be frequency ranks, as given by a RankedReader, so that every transaction is a sorted array
+ * of ranks and the conditional database of an item only keeps the items before it. Each database is stored in flat
+ * arrays, reduced by removing its infrequent items and merging its identical transactions, and the transactions
+ * containing every item are gathered with a single scan by occurrence delivery. The first level items are mined in
+ * parallel, the deeper levels by the task of their first item.
+ */
+template <typename T>
+class LCMMiner {
+public:
+	// Receives the itemsets of every first level item as soon as they are mined, one call at a time
+	typedef std::function<void(std::list<Itemset<T>>& itemsets)> Sink;
+
+	LCMMiner(TransactionReader& reader, const double supportFraction, const MiningSettings& settings = MiningSettings());
+	std::list<Itemset<T>> getFrequentItemsets() const;
+	void getFrequentItemsets(const Sink& sink) const;
+	int getSupportCount() const;
+
+private:
+	struct Database {
+		// Items of all the transactions one after the other, the transaction i is between offsets[i] and offsets[i + 1]
+		std::vector<T> items;
+		std::vector<size_t> offsets = {0};
+		std::vector<int> weights;
+	};
+
+	/**
+	 * Reduced database together with its occurrence lists, the transactions containing the frequent item i are
+	 * between occurrenceOffsets[i] and occurrenceOffsets[i + 1].
+	 */
+	struct Occurrences {
+		Database database;
+		std::vector<T> items;
+		std::vector<int> supports;
+		std::vector<size_t> occurrences;
+		std::vector<size_t> occurrenceOffsets;
+	};
+
+	int supportCount;
+	int nThreads;
+	Database database;
+
+	std::list<Itemset<T>> mine(const Sink& sink) const;
+	Occurrences deliver(const Database& database) const;
+	Database project(const Occurrences& occurrences, const size_t item) const;
+	void expand(const Database& database, std::vector<T>& prefix, std::list<Itemset<T>>& frequentItemsets) const;
+};
+
+template class LCMMiner<uint16_t>;
+template class LCMMiner<uint32_t>;
+template class LCMMiner<uint64_t>;
+
+#endif //FREQUENTPATTERNMINING_LCMMINER_H
@@ -0,0 +1,121 @@
+#include <iomanip>
+#include <sstream>
+#include "MemoryAccounting.h"
+
+using namespace std;
+
+MemoryAccounting::ThreadGauges::ThreadGauges() {
+	lock_guard<mutex> lock(threadsMutex);
+	threads.push_back(this);
+}
+
+MemoryAccounting::ThreadGauges::~ThreadGauges() {
+	lock_guard<mutex> lock(threadsMutex);
+	this->publish();
+	threads.remove(this);
+}
+
+void MemoryAccounting::ThreadGauges::publish() {
+	// The changes are taken atomically, so that the thread and a concurrent fold never add the same ones twice
+	long long changedNodes = 0, changedBytes = 0, conditionalChangedNodes = 0, conditionalChangedBytes = 0;
+	const int depths = this->depths.load(memory_order_relaxed);
+	for (int depth = 0; depth < depths; depth++) {
+		const long long nodes = this->nodes[depth].exchange(0, memory_order_relaxed);
+		const long long bytes = this->bytes[depth].exchange(0, memory_order_relaxed);
+		if (nodes == 0 && bytes == 0) {
+			continue;
+		}
+		MemoryAccounting::nodes[depth].add(nodes);
+		MemoryAccounting::bytes[depth].add(bytes);
+		changedNodes += nodes;
+		changedBytes += bytes;
+		if (depth > 0) {
+			conditionalChangedNodes += nodes;
+			conditionalChangedBytes += bytes;
+		}
+	}
+	totalNodes.add(changedNodes);
+	totalBytes.add(changedBytes);
+	conditionalNodes.add(conditionalChangedNodes);
+	conditionalBytes.add(conditionalChangedBytes);
+	MemoryAccounting::headerTables.add(this->headerTables.exchange(0, memory_order_relaxed));
+	MemoryAccounting::headerEntries.add(this->headerEntries.exchange(0, memory_order_relaxed));
+}
+
+void MemoryAccounting::fold() {
+	lock_guard<mutex> lock(threadsMutex);
+	for (ThreadGauges* local : threads) {
+		local->publish();
+	}
+}
+
+string MemoryAccounting::getSummary() {
+	fold();
+	ostringstream summary;
+	summary << fixed << setprecision(1)
+	        << "Peak FP-Tree footprint: " << totalNodes.peak << " nodes (" << totalBytes.peak / 1048576.0 << " MB), "
+	        << conditionalNodes.peak << " nodes (" << conditionalBytes.peak / 1048576.0 << " MB) in conditional trees, "
+	        << headerEntries.peak << " header table entries in " << headerTables.peak << " header tables";
+	return summary.str();
+}
+
+string MemoryAccounting::toJSON(const string& indentation) {
+	fold();
+	ostringstream json;
+	json << "{\n"
+	     << indentation << "  \"peakNodes\": " << totalNodes.peak << ",\n"
+	     << indentation << "  \"peakBytes\": " << totalBytes.peak << ",\n"
+	     << indentation << "  \"liveNodes\": " << totalNodes.live << ",\n"
+	     << indentation << "  \"liveBytes\": " << totalBytes.live << ",\n"
+	     << indentation << "  \"initialPeakNodes\": " << nodes[0].peak << ",\n"
+	     << indentation << "  \"initialPeakBytes\": " << bytes[0].peak << ",\n"
+	     << indentation << "  \"conditionalPeakNodes\": " << conditionalNodes.peak << ",\n"
+	     << indentation << "  \"conditionalPeakBytes\": " << conditionalBytes.peak << ",\n"
+	     << indentation << "  \"peakHeaderTables\": " << headerTables.peak << ",\n"
+	     << indentation << "  \"peakHeaderEntries\": " << headerEntries.peak << ",\n"
+	     << indentation << "  \"depths\": [";
+	int depths = MAX_DEPTH;
+	while (depths > 0 && nodes[depths - 1].peak == 0) {
+		depths--;
+	}
+	for (int depth = 0; depth < depths; depth++) {
+		json << (depth == 0 ? "" : ",") << "\n" << indentation << "    {\"depth\": " << depth
+		     << ", \"peakNodes\": " << nodes[depth].peak << ", \"peakBytes\": " << bytes[depth].peak << "}";
+	}
+	json << "\n" << indentation << "  ]\n" << indentation << "}";
+	return json.str();
+}
+
+void MemoryAccounting::startSampling(const chrono::milliseconds interval, function<void(const string&)> hook) {
+	stopSampling();
+	sampling = true;
+	sampler = thread([interval, hook]() {
+		const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		unique_lock<mutex> lock(samplerMutex);
+		while (!samplerCondition.wait_for(lock, interval, []() { return !sampling; })) {
+			hook(getSample(start));
+		}
+		// The last sample reports the state at the end of the sampling
+		hook(getSample(start));
+	});
+}
+
+void MemoryAccounting::stopSampling() {
+	{
+		lock_guard<mutex> lock(samplerMutex);
+		sampling = false;
+	}
+	samplerCondition.notify_all();
+	if (sampler.joinable()) {
+		sampler.join();
+	}
+}
+
+string MemoryAccounting::getSample(const chrono::steady_clock::time_point start) {
+	ostringstream sample;
+	sample << "{\"seconds\": " << chrono::duration<double>(chrono::steady_clock::now() - start).count()
+	       << ", \"liveNodes\": " << totalNodes.live << ", \"liveBytes\": " << totalBytes.live
+	       << ", \"conditionalNodes\": " << conditionalNodes.live << ", \"conditionalBytes\": " << conditionalBytes.live
+	       << ", \"headerEntries\": " << headerEntries.live << "}";
+	return sample.str();
+}
@@ -0,0 +1,155 @@
+#ifndef FREQUENTPATTERNMINING_MEMORYACCOUNTING_H
+#define FREQUENTPATTERNMINING_MEMORYACCOUNTING_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * Live and peak footprint of the FP-Tree nodes, by recursion depth (0 is the initial tree and its copies, d the
+ * conditional trees of the prefixes of d items) and of the header tables. A node is accounted as its own object plus
+ * its shared pointer control block and its entry in the children of the parent, hence the bytes are an estimate of the
+ * heap actually used. Every thread keeps its changes for itself and adds them to the shared gauges only every
+ * BATCH_CHANGES of them, so that the threads do not contend for the same counters at every node: the live figures
+ * sampled while mining, and hence the peaks, may miss up to that many changes per thread. The changes still kept by the
+ * threads are folded in when the summary is requested, after the parallel work is over. Optionally a background thread
+ * samples the live figures and passes them to a hook. The accounting is turned on by the programs reporting it before
+ * any tree is built, while it is off every change costs a single branch on a static flag.
+ */
+class MemoryAccounting {
+public:
+	// Depths are stored in a byte of every node, deeper recursions are accounted to the last depth
+	static constexpr int MAX_DEPTH = 256;
+	// Changes kept by a thread before adding them to the shared gauges
+	static constexpr int BATCH_CHANGES = 256;
+
+	inline static bool enabled = false;
+
+	static void allocateNode(const int depth, const long long bytes);
+	static void releaseNode(const int depth, const long long bytes);
+	static void releaseNodes(const int depth, const long long nodes, const long long bytes);
+	static void addHeaderTables(const long long tables);
+	static void addHeaderEntries(const long long entries);
+	static std::string getSummary();
+	static std::string toJSON(const std::string& indentation);
+	static void startSampling(const std::chrono::milliseconds interval, std::function<void(const std::string&)> hook);
+	static void stopSampling();
+
+private:
+	/**
+	 * Live value and maximum it has ever reached, updated without locks.
+	 */
+	struct Gauge {
+		std::atomic<long long> live;
+		std::atomic<long long> peak;
+
+		void add(const long long amount);
+	};
+
+	/**
+	 * Changes of a thread not added to the shared gauges yet, they are added when the thread ends as well. The counters
+	 * are only contended when the summary folds them in, still they are atomic since that happens from another thread.
+	 */
+	struct ThreadGauges {
+		std::atomic<long long> nodes[MAX_DEPTH] = {};
+		std::atomic<long long> bytes[MAX_DEPTH] = {};
+		std::atomic<long long> headerTables = 0;
+		std::atomic<long long> headerEntries = 0;
+		// Only the first depths are ever changed by the thread
+		std::atomic<int> depths = 0;
+		// Only used by the thread itself
+		int changes = 0;
+
+		ThreadGauges();
+		~ThreadGauges();
+		void changeNodes(const int depth, const long long nodes, const long long bytes);
+		void change();
+		void publish();
+	};
+
+	inline static Gauge nodes[MAX_DEPTH];
+	inline static Gauge bytes[MAX_DEPTH];
+	inline static Gauge totalNodes;
+	inline static Gauge totalBytes;
+	inline static Gauge conditionalNodes;
+	inline static Gauge conditionalBytes;
+	inline static Gauge headerTables;
+	inline static Gauge headerEntries;
+	inline static std::thread sampler;
+	inline static std::mutex samplerMutex;
+	inline static std::condition_variable samplerCondition;
+	inline static bool sampling;
+	inline static std::mutex threadsMutex;
+	inline static std::list<ThreadGauges*> threads;
+	inline static thread_local ThreadGauges threadGauges;
+
+	static void fold();
+	static std::string getSample(const std::chrono::steady_clock::time_point start);
+};
+
+inline void MemoryAccounting::Gauge::add(const long long amount) {
+	const long long current = this->live.fetch_add(amount, std::memory_order_relaxed) + amount;
+	long long previous = this->peak.load(std::memory_order_relaxed);
+	while (current > previous && !this->peak.compare_exchange_weak(previous, current, std::memory_order_relaxed));
+}
+
+inline void MemoryAccounting::ThreadGauges::changeNodes(const int depth, const long long nodes, const long long bytes) {
+	this->nodes[depth].fetch_add(nodes, std::memory_order_relaxed);
+	this->bytes[depth].fetch_add(bytes, std::memory_order_relaxed);
+	if (depth >= this->depths.load(std::memory_order_relaxed)) {
+		this->depths.store(depth + 1, std::memory_order_relaxed);
+	}
+	this->change();
+}
+
+inline void MemoryAccounting::ThreadGauges::change() {
+	if (++this->changes == BATCH_CHANGES) {
+		this->changes = 0;
+		this->publish();
+	}
+}
+
+inline void MemoryAccounting::allocateNode(const int depth, const long long nodeBytes) {
+	if (!enabled) {
+		return;
+	}
+	threadGauges.changeNodes(depth, 1, nodeBytes);
+}
+
+inline void MemoryAccounting::releaseNode(const int depth, const long long nodeBytes) {
+	if (!enabled) {
+		return;
+	}
+	threadGauges.changeNodes(depth, -1, -nodeBytes);
+}
+
+inline void MemoryAccounting::releaseNodes(const int depth, const long long nodes, const long long nodeBytes) {
+	if (!enabled || nodes == 0) {
+		return;
+	}
+	threadGauges.changeNodes(depth, -nodes, -nodeBytes);
+}
+
+inline void MemoryAccounting::addHeaderTables(const long long tables) {
+	if (!enabled) {
+		return;
+	}
+	threadGauges.headerTables.fetch_add(tables, std::memory_order_relaxed);
+	threadGauges.change();
+}
+
+inline void MemoryAccounting::addHeaderEntries(const long long entries) {
+	if (!enabled) {
+		return;
+	}
+	threadGauges.headerEntries.fetch_add(entries, std::memory_order_relaxed);
+	threadGauges.change();
+}
+
+#endif //FREQUENTPATTERNMINING_MEMORYACCOUNTING_H
@@ -0,0 +1,18 @@
+#include "MemoryOrderedReader.h"
+
+using namespace std;
+
+list<int> MemoryOrderedReader::getNextTransaction() {
+	list<int> itemset;
+	#pragma omp critical
+	{
+		if (!this->eof) {
+			this->eof = this->next(itemset);
+		}
+	}
+	return itemset; // RVO
+}
+
+bool MemoryOrderedReader::isEOF() const {
+	return this->eof;
+}
@@ -0,0 +1,48 @@
+#ifndef FREQUENTPATTERNMINING_MEMORY_ORDERED_READER_H
+#define FREQUENTPATTERNMINING_MEMORY_ORDERED_READER_H
+
+#include <functional>
+#include <iterator>
+#include <list>
+#include "Statistics.h"
+#include "TransactionReader.h"
+
+/**
+ * Reads the transactions from a range of containers of items already in memory (e.g. a vector of vectors or of spans),
+ * without copying them. The range is traversed twice, once to determine the frequency of each item and once while the
+ * FP-Tree is built, hence it must be a forward range that outlives the reader.
+ * Warning: Multiple identical items in the same transaction will be simplified to one.
+ */
+class MemoryOrderedReader : public TransactionReader {
+public:
+	template <typename Iterator>
+	MemoryOrderedReader(Iterator begin, Iterator end);
+	~MemoryOrderedReader() = default;
+	std::list<int> getNextTransaction() override;
+	bool isEOF() const override;
+
+private:
+	// Type-erased cursor over the range, it returns whether the range has been exhausted by the last transaction read
+	std::function<bool(std::list<int>&)> next;
+	bool eof;
+};
+
+template <typename Iterator>
+MemoryOrderedReader::MemoryOrderedReader(Iterator begin, Iterator end) : eof(begin == end) {
+	Statistics::Phase phase("frequencyPass");
+	for (Iterator it = begin; it != end; ++it) {
+		if (std::begin(*it) == std::end(*it)) {
+			continue;
+		}
+		for (const auto& item : *it) {
+			this->increaseFrequency(item);
+		}
+		this->transactionCount++;
+	}
+	this->next = [begin, end](std::list<int>& transaction) mutable {
+		transaction.assign(std::begin(*begin), std::end(*begin));
+		return ++begin == end;
+	};
+}
+
+#endif //FREQUENTPATTERNMINING_MEMORY_ORDERED_READER_H
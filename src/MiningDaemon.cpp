@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "MiningDaemon.h"
+#include "FileOrderedReader.h"
+#include "FrequentItemsets.h"
+#include "Params.h"
+
+using namespace std;
+
+template <typename T>
+MiningDaemon<T>::MiningDaemon(string socketPath, const int cacheSize, const int workerCount) : socketPath(socketPath),
+                                                                                               cacheSize(cacheSize),
+                                                                                               workerCount(workerCount),
+                                                                                               listener(-1),
+                                                                                               wakeup{-1, -1},
+                                                                                               stopped(false) {
+	if (cacheSize < 0) {
+		throw invalid_argument("The cache size cannot be negative");
+	}
+	if (workerCount <= 0) {
+		throw invalid_argument("The number of workers must be positive");
+	}
+	omp_init_lock(&this->cacheLock);
+}
+
+template <typename T>
+MiningDaemon<T>::~MiningDaemon() {
+	if (this->listener >= 0) {
+		close(this->listener);
+		unlink(this->socketPath.c_str());
+	}
+	for (const int socket : this->wakeup) {
+		if (socket >= 0) {
+			close(socket);
+		}
+	}
+	omp_destroy_lock(&this->cacheLock);
+}
+
+template <typename T>
+void MiningDaemon<T>::addDataset(const string& name, const string& path) {
+	FileOrderedReader reader(path);
+	Dataset dataset;
+	// Every worker mines with its share of the threads, the conditional trees inherit it from the resident one
+	MiningSettings settings;
+	settings.nThreads = max(1, settings.nThreads / this->workerCount);
+	// The tree is not pruned, so that it can be mined with any support
+	dataset.manager = make_unique<FPTreeManager<T>>(reader, 0, settings);
+	dataset.transactionCount = reader.getTransactionCount();
+	DEBUG(cout << "Loaded dataset " << name << " with " << dataset.transactionCount << " transactions")
+	this->datasets[name] = move(dataset);
+}
+
+template <typename T>
+void MiningDaemon<T>::run() {
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if (this->socketPath.size() >= sizeof(address.sun_path)) {
+		throw invalid_argument("The socket path is too long");
+	}
+	strcpy(address.sun_path, this->socketPath.c_str());
+	this->listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	// A socket left behind by a previous daemon would make the bind fail
+	unlink(this->socketPath.c_str());
+	if (this->listener < 0 || bind(this->listener, (sockaddr*) &address, sizeof(address)) < 0 || listen(this->listener, SOMAXCONN) < 0) {
+		throw runtime_error("Cannot listen on " + this->socketPath + ": " + strerror(errno));
+	}
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, this->wakeup) < 0) {
+		throw runtime_error(string("Cannot create the wake up sockets: ") + strerror(errno));
+	}
+	// Requests are mined by plain threads, a nested parallel region in an OpenMP task would only have one thread
+	vector<thread> workers;
+	for (int i = 0; i < this->workerCount; i++) {
+		workers.emplace_back(&MiningDaemon<T>::work, this);
+	}
+	vector<pollfd> sockets;
+	char chunk[4096];
+	while (!this->stopped) {
+		sockets.assign({{this->listener, POLLIN, 0}, {this->wakeup[0], POLLIN, 0}});
+		// The connections waiting for an answer are not read, so that their requests are answered in order
+		for (const auto& [socket, connection] : this->connections) {
+			if (!connection.busy && !connection.closed) {
+				sockets.push_back({socket, POLLIN, 0});
+			}
+		}
+		if (poll(sockets.data(), sockets.size(), -1) < 0) {
+			if (errno != EINTR) {
+				cerr << "Cannot poll the connections: " << strerror(errno) << endl;
+				this->stop();
+			}
+			continue;
+		}
+		if (sockets[1].revents) {
+			recv(this->wakeup[0], chunk, sizeof(chunk), MSG_DONTWAIT);
+		}
+		list<pair<int, bool>> answered;
+		{
+			lock_guard<mutex> lock(this->requestMutex);
+			answered.swap(this->answered);
+		}
+		for (const auto& [socket, sent] : answered) {
+			Connection& connection = this->connections.at(socket);
+			connection.busy = false;
+			// The client may have gone away, which must not terminate the daemon
+			if (!sent) {
+				connection.buffer.clear();
+				connection.closed = true;
+			}
+			this->dispatch(socket);
+		}
+		if (sockets[0].revents) {
+			const int connection = accept(this->listener, nullptr, nullptr);
+			if (connection >= 0) {
+				this->connections.emplace(connection, Connection());
+			} else if (!this->stopped && errno != EINTR && errno != ECONNABORTED) {
+				cerr << "Cannot accept connections: " << strerror(errno) << endl;
+				this->stop();
+			}
+		}
+		for (size_t i = 2; i < sockets.size(); i++) {
+			if (!sockets[i].revents) {
+				continue;
+			}
+			Connection& connection = this->connections.at(sockets[i].fd);
+			const ssize_t size = recv(sockets[i].fd, chunk, sizeof(chunk), 0);
+			if (size > 0) {
+				connection.buffer.append(chunk, size);
+			} else {
+				connection.closed = true;
+			}
+			this->dispatch(sockets[i].fd);
+		}
+	}
+	// The queued requests are still answered, then the idle clients are disconnected
+	for (thread& worker : workers) {
+		worker.join();
+	}
+	for (const auto& [socket, connection] : this->connections) {
+		close(socket);
+	}
+	this->connections.clear();
+}
+
+template <typename T>
+void MiningDaemon<T>::dispatch(const int socket) {
+	Connection& connection = this->connections.at(socket);
+	if (connection.busy) {
+		return;
+	}
+	const size_t end = connection.buffer.find('\n');
+	if (end != string::npos) {
+		{
+			lock_guard<mutex> lock(this->requestMutex);
+			this->requests.emplace_back(socket, connection.buffer.substr(0, end));
+		}
+		connection.buffer.erase(0, end + 1);
+		connection.busy = true;
+		this->requestCondition.notify_one();
+	} else if (connection.closed) {
+		close(socket);
+		this->connections.erase(socket);
+	}
+}
+
+template <typename T>
+void MiningDaemon<T>::work() {
+	while (true) {
+		pair<int, string> request;
+		{
+			unique_lock<mutex> lock(this->requestMutex);
+			this->requestCondition.wait(lock, [this]() { return this->stopped || !this->requests.empty(); });
+			if (this->requests.empty()) {
+				return;
+			}
+			request = move(this->requests.front());
+			this->requests.pop_front();
+		}
+		const string response = this->handle(request.second);
+		bool sent = true;
+		for (size_t offset = 0; sent && offset < response.size();) {
+			const ssize_t size = send(request.first, response.data() + offset, response.size() - offset, MSG_NOSIGNAL);
+			sent = size >= 0;
+			offset += sent ? size : 0;
+		}
+		{
+			lock_guard<mutex> lock(this->requestMutex);
+			this->answered.emplace_back(request.first, sent);
+		}
+		const char byte = 0;
+		send(this->wakeup[1], &byte, 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+	}
+}
+
+template <typename T>
+string MiningDaemon<T>::handle(const string& request) {
+	istringstream input(request);
+	string command, name;
+	input >> command;
+	ostringstream output;
+	try {
+		if (command == "MINE") {
+			double supportFraction;
+			if (!(input >> name >> supportFraction) || supportFraction <= 0 || supportFraction > 100) {
+				throw invalid_argument("Usage: MINE <dataset> <support %>");
+			}
+			const int supportCount = this->getDataset(name).transactionCount * supportFraction / 100;
+			// Without any support every subset of every transaction would be enumerated on the unpruned tree
+			if (supportCount < 1) {
+				throw invalid_argument("The support of " + to_string(supportFraction) + "% is less than one transaction of " + name);
+			}
+			CacheValue frequentItemsets = this->mine(name, supportCount);
+			output << "OK " << frequentItemsets->size() << "\n";
+			for (const Itemset<T>& itemset : *frequentItemsets) {
+				for (const T& item : itemset.items) {
+					output << item << " ";
+				}
+				output << "(" << itemset.support << ")\n";
+			}
+		} else if (command == "COUNT") {
+			if (!(input >> name)) {
+				throw invalid_argument("Usage: COUNT <dataset> <item>...");
+			}
+			list<T> items;
+			T item;
+			while (input >> item) {
+				items.push_back(item);
+			}
+			if (!input.eof()) {
+				throw invalid_argument("Invalid item in " + request);
+			}
+			output << "OK " << this->getDataset(name).manager->getSupport(items) << "\n";
+		} else if (command == "SHUTDOWN") {
+			this->stop();
+			output << "OK\n";
+		} else {
+			throw invalid_argument("Unknown request " + command);
+		}
+	} catch (exception& e) {
+		output.str("");
+		output << "ERROR " << e.what() << "\n";
+	}
+	DEBUG(cout << "Served request " << request)
+	return output.str();
+}
+
+template <typename T>
+typename MiningDaemon<T>::CacheValue MiningDaemon<T>::mine(const string& name, const int supportCount) {
+	const CacheKey key(name, supportCount);
+	CacheValue frequentItemsets;
+	omp_set_lock(&this->cacheLock);
+	typename map<CacheKey, typename list<pair<CacheKey, CacheValue>>::iterator>::iterator it = this->cacheIndex.find(key);
+	if (it != this->cacheIndex.end()) {
+		this->cache.splice(this->cache.begin(), this->cache, it->second);
+		frequentItemsets = it->second->second;
+	}
+	omp_unset_lock(&this->cacheLock);
+	if (frequentItemsets) {
+		return frequentItemsets;
+	}
+	{
+		// The conditional trees are built from the resident tree, which is left as it is for the other requests
+		FrequentItemsets<T> minedFrequentItemsets(*this->getDataset(name).manager, supportCount);
+		frequentItemsets = make_shared<const list<Itemset<T>>>(minedFrequentItemsets.getFrequentItemsets());
+	}
+	omp_set_lock(&this->cacheLock);
+	if (this->cacheSize > 0 && !this->cacheIndex.contains(key)) {
+		this->cache.emplace_front(key, frequentItemsets);
+		this->cacheIndex.emplace(key, this->cache.begin());
+		if ((int) this->cache.size() > this->cacheSize) {
+			this->cacheIndex.erase(this->cache.back().first);
+			this->cache.pop_back();
+		}
+	}
+	omp_unset_lock(&this->cacheLock);
+	return frequentItemsets;
+}
+
+template <typename T>
+const typename MiningDaemon<T>::Dataset& MiningDaemon<T>::getDataset(const string& name) const {
+	typename map<string, Dataset>::const_iterator it = this->datasets.find(name);
+	if (it == this->datasets.cend()) {
+		throw invalid_argument("Unknown dataset " + name);
+	}
+	return it->second;
+}
+
+template <typename T>
+void MiningDaemon<T>::stop() {
+	{
+		lock_guard<mutex> lock(this->requestMutex);
+		this->stopped = true;
+	}
+	this->requestCondition.notify_all();
+	// Wakes up the thread polling the sockets
+	const char byte = 0;
+	send(this->wakeup[1], &byte, 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+}
@@ -0,0 +1,86 @@
+#ifndef FREQUENTPATTERNMINING_MININGDAEMON_H
+#define FREQUENTPATTERNMINING_MININGDAEMON_H
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <omp.h>
+#include "FPTreeManager.h"
+#include "Itemset.h"
+
+/**
+ * Long-running server that keeps the unpruned FP-Tree of every dataset in memory and answers the requests received on
+ * a Unix domain socket, so that the input is read and the tree is built only once. A single thread polls the listener
+ * and the connections and queues every complete request, which is answered by one of a fixed pool of workers outside
+ * of OpenMP; the threads are split evenly among the workers, so that concurrent requests do not oversubscribe the
+ * cores. The requests of a connection are answered one at a time and in order. The resident trees are only read, and
+ * the frequent itemsets of the most recent (dataset, support count) pairs are cached.
+ * Requests and responses are new-line terminated text:
+ *   MINE <dataset> <support %>      OK <count>, followed by one line per itemset with its support in brackets
+ *   COUNT <dataset> <item>...       OK <support>
+ *   SHUTDOWN                        OK, the daemon answers the queued requests and closes every connection
+ * Failed requests are answered with ERROR <message>.
+ */
+template <typename T>
+class MiningDaemon {
+public:
+	MiningDaemon(std::string socketPath, const int cacheSize, const int workerCount);
+	MiningDaemon(const MiningDaemon<T>&) = delete;
+	~MiningDaemon();
+	void addDataset(const std::string& name, const std::string& path);
+	void run();
+
+private:
+	typedef std::pair<std::string, int> CacheKey;
+	typedef std::shared_ptr<const std::list<Itemset<T>>> CacheValue;
+
+	struct Dataset {
+		std::unique_ptr<FPTreeManager<T>> manager;
+		int transactionCount;
+	};
+
+	struct Connection {
+		// Bytes received after the last complete request
+		std::string buffer;
+		// One of its requests is being answered, the next ones wait for it
+		bool busy = false;
+		// The client sends no more requests, the connection is closed once they are answered
+		bool closed = false;
+	};
+
+	std::string socketPath;
+	int cacheSize;
+	int workerCount;
+	int listener;
+	// Socket pair waking up the polling thread when a request is answered or the daemon stops
+	int wakeup[2];
+	std::atomic<bool> stopped;
+	// Only handled by the polling thread
+	std::map<int, Connection> connections;
+	// Requests waiting for a worker, and the connections whose request has been answered, with whether it was sent
+	std::list<std::pair<int, std::string>> requests;
+	std::list<std::pair<int, bool>> answered;
+	std::mutex requestMutex;
+	std::condition_variable requestCondition;
+	std::map<std::string, Dataset> datasets;
+	// Most recently used entries first
+	std::list<std::pair<CacheKey, CacheValue>> cache;
+	std::map<CacheKey, typename std::list<std::pair<CacheKey, CacheValue>>::iterator> cacheIndex;
+	omp_lock_t cacheLock;
+
+	void dispatch(const int connection);
+	void work();
+	std::string handle(const std::string& request);
+	CacheValue mine(const std::string& name, const int supportCount);
+	const Dataset& getDataset(const std::string& name) const;
+	void stop();
+};
+
+template class MiningDaemon<int>;
+
+#endif //FREQUENTPATTERNMINING_MININGDAEMON_H
@@ -3,6 +3,7 @@
 
 #include <string.h>
 #include <iomanip>
+#include <omp.h>
 #define __FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
 #define DEBUG(x) if (Params::debug) { \
                    _Pragma("omp critical(logEntry)") \
@@ -13,10 +14,35 @@
                    } \
 								 }
 
+/**
+ * Mining engine of the plain input mining, both give the same itemsets.
+ */
+enum class Engine {
+	FP_GROWTH,
+	// Array databases in the style of LCM, meant for sparse datasets with many items
+	LCM
+};
+
 struct Params {
 	inline static bool debug;
 	inline static int nThreads;
 	inline static bool parallelDelete;
+	inline static bool pseudoProjection;
+	inline static Engine engine = Engine::FP_GROWTH;
+	// Pseudo-projections with at most this many paths are materialized as conditional FP-Trees, by default only the ones
+	// of a single path, whose itemsets are enumerated right away
+	inline static int materializeThreshold = 1;
+};
+
+/**
+ * Execution settings of a mining run, kept by every FP-Tree and handed down to the trees derived from it, so that runs
+ * with different settings can share the process. By default they are the global ones given on the command line.
+ */
+struct MiningSettings {
+	int nThreads = Params::nThreads > 0 ? Params::nThreads : omp_get_max_threads();
+	bool parallelDelete = Params::parallelDelete;
+	bool pseudoProjection = Params::pseudoProjection;
+	int materializeThreshold = Params::materializeThreshold;
 };
 
 #endif //FREQUENTPATTERNMINING_PARAMS_H
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include "ProjectedDatabases.h"
+#include "FileOrderedReader.h"
+#include "FPTreeManager.h"
+#include "FrequentItemsets.h"
+#include "Params.h"
+
+using namespace std;
+
+template <typename T>
+ProjectedDatabases<T>::ProjectedDatabases(TransactionReader& reader, const double supportFraction, string directory, const long long memoryBudget)
+		: ProjectedDatabases(reader, reader.getSupportCount(supportFraction), directory, memoryBudget) { }
+
+template <typename T>
+ProjectedDatabases<T>::ProjectedDatabases(TransactionReader& reader, const int supportCount, string directory, const long long memoryBudget) : directory(directory),
+                                                                                                                                               memoryBudget(memoryBudget),
+                                                                                                                                               supportCount(supportCount) {
+	filesystem::create_directories(this->directory);
+	DEBUG(cout << "Total itemsets: " << reader.getTransactionCount() << ", support count: " << this->supportCount)
+	this->project(reader);
+	// Mine first the biggest projected databases, grouping together the ones that fit in the memory budget
+	vector<pair<long long, T>> sizes;
+	for (const auto& [item, support] : this->supports) {
+		if (support >= this->supportCount) {
+			const string path = this->getPath(item);
+			sizes.emplace_back(filesystem::exists(path) ? filesystem::file_size(path) * MEMORY_FACTOR : 0, item);
+		}
+	}
+	sort(sizes.begin(), sizes.end(), [](const pair<long long, T>& a, const pair<long long, T>& b) { return a.first > b.first; });
+	vector<list<Itemset<T>>> results(sizes.size());
+	for (size_t begin = 0, end; begin < sizes.size(); begin = end) {
+		long long memory = sizes[begin].first;
+		for (end = begin + 1; end < sizes.size() && memory + sizes[end].first <= this->memoryBudget; end++) {
+			memory += sizes[end].first;
+		}
+		DEBUG(cout << "Mining " << end - begin << " projected databases with an estimated footprint of " << memory << " bytes")
+		// A single projected database is mined using all the threads, otherwise every thread mines a different one
+		#pragma omp parallel for schedule(dynamic) shared(sizes, results, begin, end) default(none) if(end - begin > 1)
+		for (size_t i = begin; i < end; i++) {
+			results[i] = this->mine(sizes[i].second, sizes[i].first);
+		}
+	}
+	for (list<Itemset<T>>& result : results) {
+		this->frequentItemsets.splice(this->frequentItemsets.end(), result);
+	}
+}
+
+template <typename T>
+const list<Itemset<T>>& ProjectedDatabases<T>::getFrequentItemsets() const {
+	return this->frequentItemsets;
+}
+
+template <typename T>
+void ProjectedDatabases<T>::project(TransactionReader& reader) {
+	for (const auto& [item, frequency] : reader.getFrequencies()) {
+		if (frequency >= this->supportCount) {
+			this->supports.emplace(item, 0);
+			// Projected databases of a previous run must not be appended to
+			filesystem::remove(this->getPath(item));
+		}
+	}
+	map<T, string> buffers;
+	size_t buffered = 0;
+	while (!reader.isEOF()) {
+		string prefix;
+		for (int item : reader.getNextOrderedTransaction()) {
+			typename map<T, int>::iterator it = this->supports.find(item);
+			if (it == this->supports.end()) {
+				continue;
+			}
+			// Duplicated items have already been removed by the reader, hence this is the exact support of the item
+			it->second++;
+			if (!prefix.empty()) {
+				string& buffer = buffers[item];
+				buffer.append(prefix).back() = '\n';
+				buffered += prefix.size();
+			}
+			prefix.append(to_string(item)).push_back(' ');
+		}
+		if (buffered > BUFFER_SIZE) {
+			this->flush(buffers);
+			buffered = 0;
+		}
+	}
+	this->flush(buffers);
+}
+
+template <typename T>
+void ProjectedDatabases<T>::flush(map<T, string>& buffers) const {
+	for (auto& [item, buffer] : buffers) {
+		if (buffer.empty()) {
+			continue;
+		}
+		ofstream output(this->getPath(item), ios::app);
+		if (!(output << buffer)) {
+			throw runtime_error("Cannot write projected database " + this->getPath(item));
+		}
+		buffer.clear();
+	}
+}
+
+template <typename T>
+list<Itemset<T>> ProjectedDatabases<T>::mine(const T& item, const long long footprint) const {
+	list<Itemset<T>> frequentItemsets;
+	frequentItemsets.push_back({{item}, this->supports.at(item)});
+	const string path = this->getPath(item);
+	if (!filesystem::exists(path)) {
+		// The item appears only as the first one of its transactions
+		return frequentItemsets;
+	}
+	list<Itemset<T>> partialFrequentItemsets;
+	if (footprint > this->memoryBudget) {
+		// Its FP-Tree would not fit in the budget either, hence it is split again among the projected databases of its items
+		DEBUG(cout << "Projecting again the database of item " << item << " with an estimated footprint of " << footprint << " bytes")
+		FileOrderedReader projectedReader(path);
+		ProjectedDatabases<T> projectedDatabases(projectedReader, this->supportCount, this->getDirectory(item), this->memoryBudget);
+		partialFrequentItemsets.splice(partialFrequentItemsets.end(), projectedDatabases.frequentItemsets);
+		filesystem::remove_all(this->getDirectory(item));
+	} else {
+		FileOrderedReader projectedReader(path);
+		FPTreeManager<T> manager(projectedReader, this->supportCount);
+		FrequentItemsets<T> projectedFrequentItemsets(manager);
+		partialFrequentItemsets = projectedFrequentItemsets.getFrequentItemsets();
+	}
+	filesystem::remove(path);
+	DEBUG(cout << "Mined projected database of item " << item << ", found " << partialFrequentItemsets.size() + 1 << " frequent itemsets")
+	// Prepend the projection item to the results found
+	for (Itemset<T>& partialItemset : partialFrequentItemsets) {
+		partialItemset.items.push_front(item);
+	}
+	frequentItemsets.splice(frequentItemsets.end(), partialFrequentItemsets);
+	return frequentItemsets;
+}
+
+template <typename T>
+string ProjectedDatabases<T>::getPath(const T& item) const {
+	return this->getDirectory(item) + ".dat";
+}
+
+template <typename T>
+string ProjectedDatabases<T>::getDirectory(const T& item) const {
+	return this->directory + "/projection-" + to_string(item);
+}
@@ -0,0 +1,46 @@
+#ifndef FREQUENTPATTERNMINING_PROJECTEDDATABASES_H
+#define FREQUENTPATTERNMINING_PROJECTEDDATABASES_H
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include "TransactionReader.h"
+#include "Itemset.h"
+
+/**
+ * Out-of-core mining based on the parallel projection by Han et al.: after the frequency pass every transaction is
+ * split among the projected databases of its frequent items, which are stored on disk. The projected database of an
+ * item contains, for each transaction where the item appears, the items that precede it in the frequency order.
+ * Every projected database is then mined in memory by the FP-Tree engine, the ones that fit in the memory budget at
+ * the same time. A projected database bigger than the whole budget is projected again on disk in the same way, since its
+ * own projected databases hold strictly fewer items per transaction.
+ */
+template <typename T>
+class ProjectedDatabases {
+public:
+	ProjectedDatabases(TransactionReader& reader, const double supportFraction, std::string directory, const long long memoryBudget);
+	ProjectedDatabases(TransactionReader& reader, const int supportCount, std::string directory, const long long memoryBudget);
+	const std::list<Itemset<T>>& getFrequentItemsets() const;
+
+private:
+	// In-memory size of an FP-Tree with respect to the size of the text it has been generated from
+	static constexpr int MEMORY_FACTOR = 32;
+	// Bytes that can be buffered in memory before being appended to the projected databases
+	static constexpr size_t BUFFER_SIZE = 64 << 20;
+	std::string directory;
+	long long memoryBudget;
+	int supportCount;
+	std::map<T, int> supports;
+	std::list<Itemset<T>> frequentItemsets;
+
+	void project(TransactionReader& reader);
+	void flush(std::map<T, std::string>& buffers) const;
+	std::list<Itemset<T>> mine(const T& item, const long long footprint) const;
+	std::string getPath(const T& item) const;
+	std::string getDirectory(const T& item) const;
+};
+
+template class ProjectedDatabases<int>;
+
+#endif //FREQUENTPATTERNMINING_PROJECTEDDATABASES_H
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include "PseudoProjection.h"
+#include "FPTreeNode.h"
+#include "Params.h"
+#include "Statistics.h"
+
+using namespace std;
+
+// Scratch space indexed by item, always left zeroed between two projections: the counts of the items and the position
+// plus one of the frequent ones
+static thread_local vector<int> itemCounts;
+static thread_local vector<int> itemIndices;
+
+template <typename T>
+PseudoProjection<T>::PseudoProjection(const FPTreeManager<T>& manager) : supportCount(manager.getSupportCount()),
+                                                                          settings(manager.getSettings()),
+                                                                          items(manager.getHeaderTable().getItems()) {
+	for (size_t i = 0; i < this->items.size(); i++) {
+		this->indices.emplace(this->items[i], i);
+	}
+	this->itemNodes.resize(this->items.size());
+	// Depth-first visit, the parent of every node has already been assigned an index
+	vector<pair<const FPTreeNode<T>*, int>> pending;
+	for (const shared_ptr<FPTreeNode<T>>& child : manager.getRoot()->children) {
+		pending.emplace_back(child.get(), NONE);
+	}
+	while (!pending.empty()) {
+		const auto [node, parent] = pending.back();
+		pending.pop_back();
+		const int index = this->nodeItems.size();
+		const int item = this->indices.at(node->value);
+		this->nodeItems.push_back(item);
+		this->parents.push_back(parent);
+		this->frequencies.push_back(node->frequency);
+		this->itemNodes[item].push_back(index);
+		for (const shared_ptr<FPTreeNode<T>>& child : node->children) {
+			pending.emplace_back(child.get(), index);
+		}
+	}
+	DEBUG(cout << "Flattened FP-Tree with " << this->nodeItems.size() << " nodes and " << this->items.size() << " items")
+}
+
+template <typename T>
+int PseudoProjection<T>::getItemCount() const {
+	return this->items.size();
+}
+
+template <typename T>
+const T& PseudoProjection<T>::getItem(const int item) const {
+	return this->items[item];
+}
+
+template <typename T>
+int PseudoProjection<T>::getIndex(const T& item) const {
+	return this->indices.at(item);
+}
+
+template <typename T>
+int PseudoProjection<T>::getSupportCount() const {
+	return this->supportCount;
+}
+
+template <typename T>
+const MiningSettings& PseudoProjection<T>::getSettings() const {
+	return this->settings;
+}
+
+template <typename T>
+int PseudoProjection<T>::getTotalFrequency(const int item) const {
+	int totalFrequency = 0;
+	for (const int node : this->itemNodes[item]) {
+		totalFrequency += this->frequencies[node];
+	}
+	return totalFrequency;
+}
+
+template <typename T>
+typename PseudoProjection<T>::Projection PseudoProjection<T>::getProjection(const int item) const {
+	Statistics::increment(Statistics::PROJECTIONS);
+	// Nodes of the same item never share their parent, hence there is nothing to merge
+	Projection projection;
+	for (const int node : this->itemNodes[item]) {
+		if (this->parents[node] != NONE) {
+			projection.emplace_back(this->parents[node], this->frequencies[node]);
+		}
+	}
+	return projection;
+}
+
+template <typename T>
+typename PseudoProjection<T>::Frequencies PseudoProjection<T>::getFrequencies(const Projection& projection) const {
+	if (itemCounts.size() < this->items.size()) {
+		itemCounts.resize(this->items.size(), 0);
+	}
+	vector<int> touched;
+	for (const auto& [node, count] : projection) {
+		for (int i = node; i != NONE; i = this->parents[i]) {
+			if (itemCounts[this->nodeItems[i]] == 0) {
+				touched.push_back(this->nodeItems[i]);
+			}
+			itemCounts[this->nodeItems[i]] += count;
+		}
+	}
+	Frequencies frequencies;
+	for (const int item : touched) {
+		if (itemCounts[item] >= this->supportCount) {
+			frequencies.emplace_back(item, itemCounts[item]);
+		}
+		itemCounts[item] = 0;
+	}
+	sort(frequencies.begin(), frequencies.end());
+	return frequencies;
+}
+
+template <typename T>
+vector<typename PseudoProjection<T>::Projection> PseudoProjection<T>::project(const Projection& projection, const Frequencies& frequencies) const {
+	// The projection of every frequent item follows its position in the frequencies
+	vector<Projection> projections(frequencies.size());
+	this->setIndices(frequencies);
+	vector<int> path;
+	for (const auto& [node, count] : projection) {
+		// Items infrequent here are infrequent in every projection below, hence each path starts from the next frequent node
+		path.clear();
+		for (int i = node; i != NONE; i = this->parents[i]) {
+			if (itemIndices[this->nodeItems[i]] > 0) {
+				path.push_back(i);
+			}
+		}
+		for (size_t i = 0; i + 1 < path.size(); i++) {
+			projections[itemIndices[this->nodeItems[path[i]]] - 1].emplace_back(path[i + 1], count);
+		}
+	}
+	this->resetIndices(frequencies);
+	for (Projection& itemProjection : projections) {
+		if (itemProjection.empty()) {
+			continue;
+		}
+		Statistics::increment(Statistics::PROJECTIONS);
+		// Different paths reach the same ancestors, their counts are merged
+		sort(itemProjection.begin(), itemProjection.end());
+		typename Projection::iterator last = itemProjection.begin();
+		for (typename Projection::iterator it = next(itemProjection.begin()); it != itemProjection.end(); it++) {
+			if (it->first == last->first) {
+				last->second += it->second;
+			} else {
+				*(++last) = *it;
+			}
+		}
+		itemProjection.erase(next(last), itemProjection.end());
+	}
+	return projections;
+}
+
+template <typename T>
+unique_ptr<FPTreeManager<T>> PseudoProjection<T>::getConditionalTree(const Projection& projection, const Frequencies& frequencies, const int depth) const {
+	Statistics::increment(Statistics::PREFIX_TREES);
+	unique_ptr<FPTreeManager<T>> newManager(new FPTreeManager<T>(make_unique<Arena>(depth)));
+	newManager->supportCount = this->supportCount;
+	newManager->settings = this->settings;
+	// Every path becomes a transaction made only of its frequent items, weighted by its count
+	this->setIndices(frequencies);
+	for (const auto& [node, count] : projection) {
+		list<T> path;
+		for (int i = node; i != NONE; i = this->parents[i]) {
+			if (itemIndices[this->nodeItems[i]] > 0) {
+				path.push_front(this->items[this->nodeItems[i]]);
+			}
+		}
+		if (!path.empty()) {
+			newManager->addTransaction(path, count);
+		}
+	}
+	this->resetIndices(frequencies);
+	return move(newManager);
+}
+
+template <typename T>
+void PseudoProjection<T>::setIndices(const Frequencies& frequencies) const {
+	if (itemIndices.size() < this->items.size()) {
+		itemIndices.resize(this->items.size(), 0);
+	}
+	for (size_t i = 0; i < frequencies.size(); i++) {
+		itemIndices[frequencies[i].first] = i + 1;
+	}
+}
+
+template <typename T>
+void PseudoProjection<T>::resetIndices(const Frequencies& frequencies) const {
+	for (const auto& [item, _] : frequencies) {
+		itemIndices[item] = 0;
+	}
+}
@@ -0,0 +1,61 @@
+#ifndef FREQUENTPATTERNMINING_PSEUDOPROJECTION_H
+#define FREQUENTPATTERNMINING_PSEUDOPROJECTION_H
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "FPTreeManager.h"
+
+/**
+ * Read-only view of a pruned FP-Tree used to mine it by pseudo-projection, in the style of H-Mine. The tree is flattened
+ * once in arrays linked by index, then the conditional database of a prefix is only a list of (node, count) pairs, each
+ * one standing for the path from the node to the root repeated count times, so that no conditional tree is copied.
+ * Items are referred to by their position in the header table of the original tree. The work on a projection follows
+ * its own paths and frequent items, not the number of items of the tree, which are only looked up in scratch space of
+ * the thread.
+ */
+template <typename T>
+class PseudoProjection {
+public:
+	static constexpr int NONE = -1;
+
+	typedef std::vector<std::pair<int, int>> Projection;
+	// Items frequent in a projection with their frequency, sorted by item
+	typedef std::vector<std::pair<int, int>> Frequencies;
+
+	PseudoProjection(const FPTreeManager<T>& manager);
+	PseudoProjection(const PseudoProjection<T>&) = delete;
+	int getItemCount() const;
+	const T& getItem(const int item) const;
+	int getIndex(const T& item) const;
+	int getSupportCount() const;
+	const MiningSettings& getSettings() const;
+	int getTotalFrequency(const int item) const;
+	Projection getProjection(const int item) const;
+	Frequencies getFrequencies(const Projection& projection) const;
+	std::vector<Projection> project(const Projection& projection, const Frequencies& frequencies) const;
+	std::unique_ptr<FPTreeManager<T>> getConditionalTree(const Projection& projection, const Frequencies& frequencies, const int depth) const;
+
+private:
+	int supportCount;
+	MiningSettings settings;
+	std::vector<T> items;
+	std::unordered_map<T, int> indices;
+	// Item and parent of every node, the children of the root have no parent
+	std::vector<int> nodeItems;
+	std::vector<int> parents;
+	std::vector<int> frequencies;
+	// Nodes of every item, as the header table chains
+	std::vector<std::vector<int>> itemNodes;
+
+	void setIndices(const Frequencies& frequencies) const;
+	void resetIndices(const Frequencies& frequencies) const;
+};
+
+template class PseudoProjection<int>;
+template class PseudoProjection<uint16_t>;
+template class PseudoProjection<uint32_t>;
+template class PseudoProjection<uint64_t>;
+
+#endif //FREQUENTPATTERNMINING_PSEUDOPROJECTION_H
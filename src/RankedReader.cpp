@@ -0,0 +1,45 @@
+#include <algorithm>
+#include "RankedReader.h"
+
+using namespace std;
+
+RankedReader::RankedReader(TransactionReader& reader) : reader(reader) {
+	for (const auto& [item, _] : reader.getFrequencies()) {
+		this->items.push_back(item);
+	}
+	sort(this->items.begin(), this->items.end(), [&reader](int a, int b) { return reader.precedes(a, b); });
+	this->ranks.reserve(this->items.size());
+	for (size_t rank = 0; rank < this->items.size(); rank++) {
+		this->ranks.emplace(this->items[rank], rank);
+		this->frequencies.emplace(rank, reader.getFrequencies().at(this->items[rank]));
+	}
+	this->transactionCount = reader.getTransactionCount();
+}
+
+list<int> RankedReader::getNextTransaction() {
+	list<int> transaction = this->reader.getNextTransaction();
+	for (int& item : transaction) {
+		item = this->ranks.at(item);
+	}
+	return transaction; // RVO
+}
+
+list<int> RankedReader::getNextOrderedTransaction() {
+	list<int> transaction = this->getNextTransaction();
+	// Ranks follow the frequency order, ties included
+	transaction.sort();
+	transaction.unique();
+	return transaction; // RVO
+}
+
+bool RankedReader::isEOF() const {
+	return this->reader.isEOF();
+}
+
+int RankedReader::getItem(const int rank) const {
+	return this->items[rank];
+}
+
+size_t RankedReader::getItemCount() const {
+	return this->items.size();
+}
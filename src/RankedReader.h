@@ -0,0 +1,29 @@
+#ifndef FREQUENTPATTERNMINING_RANKEDREADER_H
+#define FREQUENTPATTERNMINING_RANKEDREADER_H
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "TransactionReader.h"
+
+/**
+ * Replaces the items of another reader with their rank in the frequency order, so that the most frequent item is 0 and
+ * the items of a reader with n distinct items are exactly 0 ... n - 1. Ordering a transaction then only requires to sort
+ * its ranks, and the ranks can be stored in the narrowest integer type that holds n.
+ */
+class RankedReader : public TransactionReader {
+public:
+	RankedReader(TransactionReader& reader);
+	std::list<int> getNextTransaction() override;
+	std::list<int> getNextOrderedTransaction() override;
+	bool isEOF() const override;
+	int getItem(const int rank) const;
+	size_t getItemCount() const;
+
+private:
+	TransactionReader& reader;
+	std::vector<int> items;
+	std::unordered_map<int, int> ranks;
+};
+
+#endif //FREQUENTPATTERNMINING_RANKEDREADER_H
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <omp.h>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include "SampleMiner.h"
+#include "MemoryOrderedReader.h"
+#include "Params.h"
+#include "Statistics.h"
+
+using namespace std;
+
+template <typename T>
+SampleMiner<T>::SampleMiner(const double sampleFraction, const double confidence, const unsigned int seed) : sampleFraction(sampleFraction),
+                                                                                                              confidence(confidence),
+                                                                                                              seed(seed),
+                                                                                                              transactionCount(0),
+                                                                                                              candidateCount(0),
+                                                                                                              borderCount(0) {
+	if (sampleFraction <= 0 || sampleFraction > 1) {
+		throw invalid_argument("The sample fraction must be in (0, 1]");
+	}
+	if (confidence <= 0 || confidence >= 1) {
+		throw invalid_argument("The confidence must be in (0, 1)");
+	}
+}
+
+template <typename T>
+void SampleMiner<T>::drawSample(TransactionReader& reader) {
+	Statistics::Phase phase("sampling");
+	mt19937 generator(this->seed);
+	bernoulli_distribution sampled(this->sampleFraction);
+	while (!reader.isEOF()) {
+		const list<int> transaction = reader.getNextTransaction();
+		list<T> items(transaction.cbegin(), transaction.cend());
+		items.sort();
+		// We do not take into consideration duplicate elements
+		items.unique();
+		if (items.empty()) {
+			continue;
+		}
+		// Single items are counted exactly here, only the bigger itemsets are left to the verification pass
+		this->transactionCount++;
+		for (const T& item : items) {
+			this->frequencies[item]++;
+		}
+		if (sampled(generator)) {
+			this->sample.push_back(move(items));
+		}
+	}
+	if (this->sample.empty()) {
+		throw runtime_error("The sample is empty, a bigger sample fraction is required");
+	}
+	DEBUG(cout << "Sampled " << this->sample.size() << " of " << this->transactionCount << " transactions")
+}
+
+template <typename T>
+int SampleMiner<T>::getTransactionCount() const {
+	return this->transactionCount;
+}
+
+template <typename T>
+int SampleMiner<T>::getSampleSize() const {
+	return this->sample.size();
+}
+
+template <typename T>
+double SampleMiner<T>::getLoweredSupportFraction(const double supportFraction) const {
+	// Both the additive Hoeffding bound and the multiplicative Chernoff bound keep the support of a frequent itemset in the
+	// sample above the lowered one with probability confidence, the former is tighter for high supports, the latter for low ones
+	const double logarithm = log(1 / (1 - this->confidence));
+	const double loweredSupportFraction = max(supportFraction - sqrt(logarithm / (2.0 * this->sample.size())),
+	                                          supportFraction * (1 - sqrt(2 * logarithm / (supportFraction * this->sample.size()))));
+	if (loweredSupportFraction < MIN_LOWERED_SUPPORT * supportFraction || loweredSupportFraction * this->sample.size() < MIN_SAMPLE_SUPPORT_COUNT) {
+		// Smallest sample whose Chernoff lowered support s * (1 - sqrt(2 * log / (s * n))) reaches both minimums
+		const double root = (sqrt(2 * logarithm) + sqrt(2 * logarithm + 4 * MIN_SAMPLE_SUPPORT_COUNT)) / 2;
+		const double requiredSize = ceil(max(root * root, 2 * logarithm / pow(1 - MIN_LOWERED_SUPPORT, 2)) / supportFraction);
+		throw runtime_error("The sample of " + to_string(this->sample.size()) + " transactions is too small for the requested support and confidence, "
+		                    + (requiredSize <= this->transactionCount ? "at least " + to_string((long) requiredSize) + " transactions are required"
+		                                                              : "a higher support or a lower confidence is required"));
+	}
+	return loweredSupportFraction;
+}
+
+template <typename T>
+double SampleMiner<T>::getErrorBound(const size_t estimateCount) const {
+	// Two-sided Hoeffding bound on the support fraction of a single itemset, with the union bound over all the estimates
+	return sqrt(log(2 * max<size_t>(estimateCount, 1) / (1 - this->confidence)) / (2.0 * this->sample.size()));
+}
+
+template <typename T>
+list<Itemset<T>> SampleMiner<T>::getEstimates(const FrequentPatternMiner<T>& miner, const double supportFraction) const {
+	if (supportFraction * this->sample.size() < MIN_SAMPLE_SUPPORT_COUNT) {
+		throw runtime_error("The sample of " + to_string(this->sample.size()) + " transactions is too small for the requested support, at least "
+		                    + to_string((long) ceil(MIN_SAMPLE_SUPPORT_COUNT / supportFraction)) + " transactions are required");
+	}
+	MemoryOrderedReader reader(this->sample.cbegin(), this->sample.cend());
+	list<Itemset<T>> estimates = miner.mine(reader, supportFraction);
+	// Supports are scaled from the sample to the whole input
+	for (Itemset<T>& estimate : estimates) {
+		estimate.support = llround((double) estimate.support * this->transactionCount / this->sample.size());
+	}
+	return estimates;
+}
+
+template <typename T>
+list<Itemset<T>> SampleMiner<T>::mine(TransactionReader& reader, const FrequentPatternMiner<T>& miner, const double supportFraction, const int batchSize) {
+	const int supportCount = this->transactionCount * supportFraction;
+	MemoryOrderedReader sampleReader(this->sample.cbegin(), this->sample.cend());
+	vector<vector<T>> candidates;
+	for (const Itemset<T>& itemset : miner.mine(sampleReader, this->getLoweredSupportFraction(supportFraction))) {
+		vector<T>& candidate = candidates.emplace_back(itemset.items.cbegin(), itemset.items.cend());
+		sort(candidate.begin(), candidate.end());
+	}
+	this->candidateCount = candidates.size();
+	vector<vector<T>> border = SampleMiner<T>::getNegativeBorder(candidates);
+	this->borderCount = border.size();
+
+	list<Itemset<T>> frequentItemsets;
+	// Single items already have their exact support, every one of them that is not a candidate is in the border
+	set<T> candidateItems;
+	vector<vector<T>> itemsets;
+	for (vector<T>& candidate : candidates) {
+		if (candidate.size() == 1) {
+			candidateItems.insert(candidate.front());
+			if (this->frequencies.at(candidate.front()) >= supportCount) {
+				frequentItemsets.push_back({{candidate.front()}, this->frequencies.at(candidate.front())});
+			}
+		} else {
+			itemsets.push_back(move(candidate));
+		}
+	}
+	for (const auto& [item, frequency] : this->frequencies) {
+		if (candidateItems.count(item) == 0) {
+			this->borderCount++;
+			if (frequency >= supportCount) {
+				frequentItemsets.push_back({{item}, frequency});
+				this->frequentBorder.push_back({{item}, frequency});
+			}
+		}
+	}
+	const size_t borderBegin = itemsets.size();
+	itemsets.insert(itemsets.end(), make_move_iterator(border.begin()), make_move_iterator(border.end()));
+
+	const vector<int> supports = this->countSupports(reader, itemsets, batchSize);
+	for (size_t i = 0; i < itemsets.size(); i++) {
+		if (supports[i] < supportCount) {
+			continue;
+		}
+		frequentItemsets.push_back({list<T>(itemsets[i].cbegin(), itemsets[i].cend()), supports[i]});
+		if (i >= borderBegin) {
+			this->frequentBorder.push_back(frequentItemsets.back());
+		}
+	}
+	return frequentItemsets;
+}
+
+template <typename T>
+int SampleMiner<T>::getCandidateCount() const {
+	return this->candidateCount;
+}
+
+template <typename T>
+int SampleMiner<T>::getBorderCount() const {
+	return this->borderCount;
+}
+
+template <typename T>
+const list<Itemset<T>>& SampleMiner<T>::getFrequentBorder() const {
+	return this->frequentBorder;
+}
+
+template <typename T>
+vector<vector<T>> SampleMiner<T>::getNegativeBorder(const vector<vector<T>>& candidates) {
+	// Apriori generation from the candidates: two candidates sharing all their items but the last one give an itemset
+	// whose subsets have to be candidates as well, the ones that are not candidates themselves are in the border
+	const set<vector<T>> candidateSet(candidates.cbegin(), candidates.cend());
+	map<size_t, vector<vector<T>>> levels;
+	for (const vector<T>& candidate : candidates) {
+		levels[candidate.size()].push_back(candidate);
+	}
+	vector<vector<T>> border;
+	vector<T> subset;
+	for (auto& [size, level] : levels) {
+		// Candidates sharing all their items but the last one are next to each other
+		sort(level.begin(), level.end());
+		for (auto first = level.cbegin(); first != level.cend(); first++) {
+			for (auto second = next(first); second != level.cend() && equal(first->cbegin(), prev(first->cend()), second->cbegin()); second++) {
+				vector<T> itemset(*first);
+				itemset.push_back(second->back());
+				if (candidateSet.count(itemset) > 0) {
+					continue;
+				}
+				// The subsets without one of the last two items are the two candidates joined
+				bool minimal = true;
+				for (size_t i = 0; minimal && i + 2 < itemset.size(); i++) {
+					subset.assign(itemset.cbegin(), itemset.cend());
+					subset.erase(subset.begin() + i);
+					minimal = candidateSet.count(subset) > 0;
+				}
+				if (minimal) {
+					border.push_back(move(itemset));
+				}
+			}
+		}
+	}
+	return border;
+}
+
+template <typename T>
+vector<int> SampleMiner<T>::countSupports(TransactionReader& reader, const vector<vector<T>>& itemsets, const int batchSize) const {
+	Statistics::Phase phase("verification");
+	map<T, int> indices;
+	for (const vector<T>& itemset : itemsets) {
+		for (const T& item : itemset) {
+			indices.emplace(item, 0);
+		}
+	}
+	int itemCount = 0;
+	for (auto& [item, index] : indices) {
+		index = itemCount++;
+	}
+	Trie trie;
+	vector<int> nodes;
+	nodes.reserve(itemsets.size());
+	vector<int> itemset;
+	for (const vector<T>& items : itemsets) {
+		itemset.clear();
+		for (const T& item : items) {
+			itemset.push_back(indices.at(item));
+		}
+		nodes.push_back(trie.insert(itemset));
+	}
+	// Every batch is turned into one bitset of its transactions per item, then the transactions containing an itemset
+	// are the intersection of the ones of its prefix with the ones of its last item
+	const size_t words = (batchSize + 63) / 64;
+	vector<uint64_t> bitsets(itemCount * words);
+	vector<int> counts(trie.children.size(), 0);
+	#pragma omp parallel shared(reader, trie, indices, bitsets, counts, batchSize, words) default(none) if(!omp_in_parallel())
+	#pragma omp single
+	while (!reader.isEOF()) {
+		fill(bitsets.begin(), bitsets.end(), 0);
+		int transaction = 0;
+		while (transaction < batchSize && !reader.isEOF()) {
+			const list<int> items = reader.getNextTransaction();
+			for (const int item : items) {
+				const auto index = indices.find(item);
+				if (index != indices.cend()) {
+					bitsets[index->second * words + transaction / 64] |= (uint64_t) 1 << (transaction % 64);
+				}
+			}
+			transaction += !items.empty();
+		}
+		// Every subtree of the root is counted by a single task, hence its counts are not shared
+		const vector<pair<int, int>>& rootChildren = trie.children.front();
+		#pragma omp taskloop shared(trie, bitsets, counts, words, rootChildren) default(none)
+		for (size_t i = 0; i < rootChildren.size(); i++) {
+			const auto [item, child] = rootChildren[i];
+			const uint64_t* transactions = bitsets.data() + item * words;
+			for (size_t j = 0; j < words; j++) {
+				counts[child] += __builtin_popcountll(transactions[j]);
+			}
+			vector<vector<uint64_t>> buffers;
+			trie.count(bitsets, words, child, transactions, buffers, 0, counts);
+		}
+	}
+	vector<int> supports;
+	supports.reserve(itemsets.size());
+	for (const int node : nodes) {
+		supports.push_back(counts[node]);
+	}
+	return supports;
+}
+
+template <typename T>
+int SampleMiner<T>::Trie::insert(const vector<int>& itemset) {
+	int node = 0;
+	for (const int item : itemset) {
+		vector<pair<int, int>>& children = this->children[node];
+		const auto child = lower_bound(children.begin(), children.end(), make_pair(item, 0));
+		if (child != children.end() && child->first == item) {
+			node = child->second;
+			continue;
+		}
+		const int newNode = this->children.size();
+		children.emplace(child, item, newNode);
+		// Adding the node may move the children of its parent, which are not used anymore
+		this->children.emplace_back();
+		node = newNode;
+	}
+	return node;
+}
+
+template <typename T>
+void SampleMiner<T>::Trie::count(const vector<uint64_t>& bitsets, const size_t words, const int node, const uint64_t* transactions,
+                                 vector<vector<uint64_t>>& buffers, const size_t depth, vector<int>& counts) const {
+	if (this->children[node].empty()) {
+		return;
+	}
+	if (buffers.size() == depth) {
+		buffers.emplace_back(words);
+	}
+	uint64_t* intersection = buffers[depth].data();
+	for (const auto& [item, child] : this->children[node]) {
+		const uint64_t* itemTransactions = bitsets.data() + item * words;
+		int count = 0;
+		for (size_t i = 0; i < words; i++) {
+			intersection[i] = transactions[i] & itemTransactions[i];
+			count += __builtin_popcountll(intersection[i]);
+		}
+		counts[child] += count;
+		// The supersets of an itemset missing from the batch are missing as well
+		if (count > 0) {
+			this->count(bitsets, words, child, intersection, buffers, depth + 1, counts);
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#ifndef FREQUENTPATTERNMINING_SAMPLEMINER_H
+#define FREQUENTPATTERNMINING_SAMPLEMINER_H
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <vector>
+#include "FrequentPatternMiner.h"
+#include "Itemset.h"
+#include "TransactionReader.h"
+
+/**
+ * Two-phase mining in the style of Toivonen's algorithm, for inputs too big to be mined exactly in reasonable time. A
+ * Bernoulli sample of the transactions is drawn while the exact item frequencies are counted, then it is mined in memory
+ * with a support lowered by a Chernoff bound, so that an itemset frequent in the whole input is missed by the sample
+ * only with probability below 1 - confidence. The candidates and their negative border, i.e. the smallest itemsets that
+ * are not candidates while all of their subsets are, are counted exactly in a single parallel pass over the input.
+ * Every itemset found is frequent with its exact support; when no itemset of the negative border is frequent the results
+ * are complete, otherwise only the supersets of the frequent border itemsets may be missing. Without the verification
+ * pass the supports of the sample are estimates, all of them within the Hoeffding bound of the true ones with probability
+ * confidence by the union bound over their number. Samples too small for the lowered support to stay above
+ * MIN_LOWERED_SUPPORT times the requested one, or above MIN_SAMPLE_SUPPORT_COUNT transactions, are rejected, since the
+ * sample would be mined with hardly any pruning.
+ */
+template <typename T>
+class SampleMiner {
+public:
+	// Below this support count in the sample about every itemset of the sampled transactions would be mined
+	static constexpr int MIN_SAMPLE_SUPPORT_COUNT = 2;
+	// Fraction of the requested support below which the lowered one keeps too many candidates for the sample to pay off
+	static constexpr double MIN_LOWERED_SUPPORT = 0.5;
+
+	SampleMiner(const double sampleFraction, const double confidence, const unsigned int seed);
+	void drawSample(TransactionReader& reader);
+	int getTransactionCount() const;
+	int getSampleSize() const;
+	double getLoweredSupportFraction(const double supportFraction) const;
+	double getErrorBound(const size_t estimateCount) const;
+	std::list<Itemset<T>> getEstimates(const FrequentPatternMiner<T>& miner, const double supportFraction) const;
+	std::list<Itemset<T>> mine(TransactionReader& reader, const FrequentPatternMiner<T>& miner, const double supportFraction, const int batchSize);
+	int getCandidateCount() const;
+	int getBorderCount() const;
+	const std::list<Itemset<T>>& getFrequentBorder() const;
+
+private:
+	/**
+	 * Prefix tree of the itemsets to count, every node stands for the itemset of its path and the children are sorted.
+	 * Items are referred to by their index among the items of the itemsets.
+	 */
+	struct Trie {
+		std::vector<std::vector<std::pair<int, int>>> children = {{}};
+
+		int insert(const std::vector<int>& itemset);
+		void count(const std::vector<uint64_t>& bitsets, const size_t words, const int node, const uint64_t* transactions,
+		           std::vector<std::vector<uint64_t>>& buffers, const size_t depth, std::vector<int>& counts) const;
+	};
+
+	double sampleFraction;
+	double confidence;
+	unsigned int seed;
+	int transactionCount;
+	std::list<std::list<T>> sample;
+	std::map<T, int> frequencies;
+	int candidateCount;
+	int borderCount;
+	std::list<Itemset<T>> frequentBorder;
+
+	static std::vector<std::vector<T>> getNegativeBorder(const std::vector<std::vector<T>>& candidates);
+	std::vector<int> countSupports(TransactionReader& reader, const std::vector<std::vector<T>>& itemsets, const int batchSize) const;
+};
+
+template class SampleMiner<int>;
+
+#endif //FREQUENTPATTERNMINING_SAMPLEMINER_H
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "ShardedMiner.h"
+#include "FrequentItemsets.h"
+#include "Params.h"
+
+using namespace std;
+
+template <typename T>
+ShardedMiner<T>::ShardedMiner(string directory, int shardCount, const chrono::seconds timeout) : directory(directory),
+                                                                                                  shardCount(shardCount),
+                                                                                                  timeout(timeout) {
+	if (shardCount <= 0) {
+		throw invalid_argument("The number of shards must be positive");
+	}
+	if (timeout < chrono::seconds::zero()) {
+		throw invalid_argument("The shard timeout cannot be negative");
+	}
+	filesystem::create_directories(this->directory);
+}
+
+template <typename T>
+void ShardedMiner<T>::clear() {
+	// Files of a previous run must not be mistaken for the ones of this run
+	for (int i = 0; i < this->shardCount; i++) {
+		filesystem::remove(this->getItemsPath(i));
+		filesystem::remove(this->getItemsetsPath(i));
+	}
+}
+
+template <typename T>
+void ShardedMiner<T>::partition(FPTreeManager<T>& manager) {
+	#pragma omp parallel shared(manager) default(none)
+	#pragma omp single
+	manager.pruneInfrequent();
+	vector<pair<long long, T>> costs;
+	for (const T& item : manager.getHeaderTable().getItems()) {
+		costs.emplace_back(estimateCost(manager, item), item);
+	}
+	// Longest processing time first: the most expensive prefix goes to the least loaded shard
+	sort(costs.begin(), costs.end(), [](const pair<long long, T>& a, const pair<long long, T>& b) { return a.first > b.first; });
+	priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> loads;
+	for (int i = 0; i < this->shardCount; i++) {
+		loads.emplace(0, i);
+	}
+	vector<vector<T>> shards(this->shardCount);
+	for (const auto& [cost, item] : costs) {
+		auto [load, shard] = loads.top();
+		loads.pop();
+		shards[shard].push_back(item);
+		loads.emplace(load + cost, shard);
+	}
+	for (int i = 0; i < this->shardCount; i++) {
+		sort(shards[i].begin(), shards[i].end());
+		ostringstream content;
+		copy(shards[i].cbegin(), shards[i].cend(), ostream_iterator<T>(content, " "));
+		atomicWrite(this->getItemsPath(i), content.str());
+		DEBUG(cout << "Shard " << i << " assigned items: " << content.str())
+	}
+}
+
+template <typename T>
+void ShardedMiner<T>::spawnWorkers(int argc, char* argv[], const int workerThreads) {
+	string threads = to_string(workerThreads);
+	for (int i = 0; i < this->shardCount; i++) {
+		// Workers are started with the arguments given by the coordinator plus the index of the shard they are responsible for
+		string shardIndex = to_string(i);
+		vector<char*> args(argv, argv + argc);
+		args.push_back(const_cast<char*>("--shardIndex"));
+		args.push_back(shardIndex.data());
+		// Without it every worker would start a thread per core
+		if (workerThreads > 0) {
+			args.push_back(const_cast<char*>("--threads"));
+			args.push_back(threads.data());
+		}
+		args.push_back(nullptr);
+		cout.flush();
+		pid_t pid = fork();
+		if (pid < 0) {
+			throw runtime_error("Cannot fork shard worker " + shardIndex);
+		}
+		if (pid == 0) {
+			// Keep the output of the workers apart from the one of the coordinator
+			const string logPath = this->directory + "/shard-" + shardIndex + ".log";
+			if (!freopen(logPath.c_str(), "w", stdout)) {
+				_exit(127);
+			}
+			execv("/proc/self/exe", args.data());
+			execvp(argv[0], args.data());
+			_exit(127);
+		}
+		this->workers.push_back(pid);
+	}
+}
+
+template <typename T>
+list<Itemset<T>> ShardedMiner<T>::collect() {
+	list<Itemset<T>> frequentItemsets;
+	const chrono::steady_clock::time_point deadline = this->getDeadline();
+	for (int i = 0; i < this->shardCount; i++) {
+		const string path = this->getItemsetsPath(i);
+		this->waitForFile(path, i, deadline);
+		ifstream input(path);
+		string line;
+		while (getline(input, line)) {
+			istringstream iss(line);
+			Itemset<T> itemset;
+			iss >> itemset.support;
+			itemset.items.assign(istream_iterator<T>(iss), istream_iterator<T>());
+			frequentItemsets.push_back(move(itemset));
+		}
+		DEBUG(cout << "Collected results of shard " << i)
+	}
+	for (pid_t& pid : this->workers) {
+		if (pid > 0) {
+			waitpid(pid, nullptr, 0);
+			pid = 0;
+		}
+	}
+	return frequentItemsets; // RVO
+}
+
+template <typename T>
+list<Itemset<T>> ShardedMiner<T>::mineShard(FPTreeManager<T>& manager, int shardIndex) {
+	if (shardIndex < 0 || shardIndex >= this->shardCount) {
+		throw invalid_argument("Shard index " + to_string(shardIndex) + " is out of range");
+	}
+	const string itemsPath = this->getItemsPath(shardIndex);
+	this->waitForFile(itemsPath, -1, this->getDeadline());
+	ifstream input(itemsPath);
+	const vector<T> prefixItems((istream_iterator<T>(input)), istream_iterator<T>());
+	cout << "Shard " << shardIndex << " mining " << prefixItems.size() << " prefix items" << endl;
+	FrequentItemsets<T> frequentItemsets(manager, prefixItems);
+	ostringstream content;
+	for (const Itemset<T>& itemset : frequentItemsets.getFrequentItemsets()) {
+		content << itemset.support << " ";
+		copy(itemset.items.cbegin(), itemset.items.cend(), ostream_iterator<T>(content, " "));
+		content << endl;
+	}
+	atomicWrite(this->getItemsetsPath(shardIndex), content.str());
+	return frequentItemsets.getFrequentItemsets();
+}
+
+template <typename T>
+string ShardedMiner<T>::getItemsPath(int shardIndex) const {
+	return this->directory + "/shard-" + to_string(shardIndex) + ".items";
+}
+
+template <typename T>
+string ShardedMiner<T>::getItemsetsPath(int shardIndex) const {
+	return this->directory + "/shard-" + to_string(shardIndex) + ".itemsets";
+}
+
+template <typename T>
+chrono::steady_clock::time_point ShardedMiner<T>::getDeadline() const {
+	return this->timeout > chrono::seconds::zero() ? chrono::steady_clock::now() + this->timeout : chrono::steady_clock::time_point::max();
+}
+
+template <typename T>
+bool ShardedMiner<T>::checkWorkers() {
+	// Local workers that terminated with an error will never produce their results
+	for (pid_t& pid : this->workers) {
+		int status;
+		if (pid > 0 && waitpid(pid, &status, WNOHANG) == pid) {
+			pid = 0;
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+template <typename T>
+long long ShardedMiner<T>::estimateCost(const FPTreeManager<T>& manager, const T& item) {
+	// The prefix tree of an item is made of all the paths from its nodes to the root
+	long long cost = 0;
+	for (shared_ptr<FPTreeNode<T>> node = manager.getHeaderTable().getNode(item); node; node = node->getNext().lock()) {
+		for (shared_ptr<FPTreeNode<T>> i = node->getParent().lock(); i->getFrequency() >= 0; i = i->getParent().lock()) {
+			cost++;
+		}
+		cost++;
+	}
+	return cost;
+}
+
+template <typename T>
+void ShardedMiner<T>::waitForFile(const string& path, const int shardIndex, const chrono::steady_clock::time_point deadline) {
+	// The file of a shard is written by its local worker, if any, hence it cannot appear once the worker is over
+	while (!filesystem::exists(path)) {
+		const bool workerOver = shardIndex >= 0 && shardIndex < (int) this->workers.size() && this->workers[shardIndex] == 0;
+		if (!this->checkWorkers() || (workerOver && !filesystem::exists(path))) {
+			throw runtime_error("Shard worker terminated without producing " + path);
+		}
+		if (chrono::steady_clock::now() > deadline) {
+			throw runtime_error("Timed out waiting for " + path);
+		}
+		this_thread::sleep_for(chrono::milliseconds(50));
+	}
+}
+
+template <typename T>
+void ShardedMiner<T>::atomicWrite(const string& path, const string& content) {
+	const string temporaryPath = path + ".tmp." + to_string(getpid());
+	{
+		ofstream output(temporaryPath, ios::trunc);
+		if (!(output << content) || !output.flush()) {
+			throw runtime_error("Cannot write " + temporaryPath);
+		}
+	}
+	filesystem::rename(temporaryPath, path);
+}
@@ -0,0 +1,53 @@
+#ifndef FREQUENTPATTERNMINING_SHARDEDMINER_H
+#define FREQUENTPATTERNMINING_SHARDEDMINER_H
+
+#include <chrono>
+#include <list>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "FPTreeManager.h"
+#include "Itemset.h"
+
+/**
+ * Splits the frequent items of the header table among a number of shards, each one mined by a different process.
+ * The coordination only relies on files in a shared directory, hence workers can run on the local machine as well as
+ * on other nodes that mount the same filesystem:
+ *  - shard-<k>.items contains the prefix items assigned to the k-th shard, written by the coordinator
+ *  - shard-<k>.itemsets contains the frequent itemsets found by the k-th worker, one per line preceded by its support,
+ *    present only once complete
+ * Both files are written to a temporary file first and then renamed, so readers never observe partial content. The
+ * coordinator clears the files of a previous run before reading the input, hence the external workers have to be
+ * started after it. Waiting for a file fails after the timeout, and as soon as the local worker that should write it has
+ * terminated.
+ */
+template <typename T>
+class ShardedMiner {
+public:
+	ShardedMiner(std::string directory, int shardCount, const std::chrono::seconds timeout = std::chrono::seconds::zero());
+	void clear();
+	void partition(FPTreeManager<T>& manager);
+	void spawnWorkers(int argc, char* argv[], const int workerThreads);
+	std::list<Itemset<T>> collect();
+	std::list<Itemset<T>> mineShard(FPTreeManager<T>& manager, int shardIndex);
+
+private:
+	std::string directory;
+	int shardCount;
+	// Longest wait for the files of the other processes, none when zero
+	std::chrono::seconds timeout;
+	// The worker of every shard, 0 once terminated
+	std::vector<pid_t> workers;
+
+	std::string getItemsPath(int shardIndex) const;
+	std::string getItemsetsPath(int shardIndex) const;
+	std::chrono::steady_clock::time_point getDeadline() const;
+	bool checkWorkers();
+	static long long estimateCost(const FPTreeManager<T>& manager, const T& item);
+	void waitForFile(const std::string& path, const int shardIndex, const std::chrono::steady_clock::time_point deadline);
+	static void atomicWrite(const std::string& path, const std::string& content);
+};
+
+template class ShardedMiner<int>;
+
+#endif //FREQUENTPATTERNMINING_SHARDEDMINER_H
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include "SlidingWindow.h"
+#include "FrequentItemsets.h"
+#include "Params.h"
+
+using namespace std;
+
+template <typename T>
+SlidingWindow<T>::SlidingWindow(const double supportFraction, const int windowBatches) : supportFraction(supportFraction),
+                                                                                         windowBatches(windowBatches),
+                                                                                         transactionCount(0),
+                                                                                         changed(false) {
+	if (windowBatches <= 0) {
+		throw invalid_argument("The window must contain at least one batch");
+	}
+}
+
+template <typename T>
+void SlidingWindow<T>::addBatch(list<list<T>>& transactions) {
+	this->rankItems(transactions);
+	vector<list<T>*> sequences;
+	for (list<T>& transaction : transactions) {
+		transaction.sort([&](const T& a, const T& b) { return this->ranks.at(a) < this->ranks.at(b); });
+		// We do not take into consideration duplicate elements
+		transaction.unique();
+		if (!transaction.empty()) {
+			sequences.push_back(&transaction);
+		}
+	}
+	// Insertions in the FP-Tree are synchronized by the node locks
+	vector<shared_ptr<FPTreeNode<T>>> handles(sequences.size());
+	#pragma omp parallel for schedule(dynamic, 64) shared(sequences, handles) default(none)
+	for (size_t i = 0; i < sequences.size(); i++) {
+		handles[i] = this->manager.addTransaction(*sequences[i]);
+	}
+	this->transactionCount += handles.size();
+	this->batches.push_back(move(handles));
+	if ((int) this->batches.size() > this->windowBatches) {
+		this->expireBatch();
+	}
+	this->changed = true;
+	DEBUG(cout << "Window updated, " << this->batches.size() << " batches and " << this->transactionCount << " transactions")
+}
+
+template <typename T>
+int SlidingWindow<T>::getTransactionCount() const {
+	return this->transactionCount;
+}
+
+template <typename T>
+const list<Itemset<T>>& SlidingWindow<T>::getFrequentItemsets() {
+	// Mine again only if the window changed since the last request
+	if (this->changed) {
+		// The live tree is only read, hence it is mined in place without copying the window
+		const FPTreeManager<T>& windowManager = this->manager;
+		FrequentItemsets<T> frequentItemsets(windowManager, (int) (this->transactionCount * this->supportFraction));
+		this->frequentItemsets = frequentItemsets.getFrequentItemsets();
+		this->changed = false;
+	}
+	return this->frequentItemsets;
+}
+
+template <typename T>
+void SlidingWindow<T>::rankItems(const list<list<T>>& transactions) {
+	map<T, int> frequencies;
+	for (const list<T>& transaction : transactions) {
+		for (const T& item : transaction) {
+			if (!this->ranks.contains(item)) {
+				frequencies[item]++;
+			}
+		}
+	}
+	// Items never seen before follow the known ones, ordered by their frequency in this batch
+	vector<pair<int, T>> newItems;
+	for (const auto& [item, frequency] : frequencies) {
+		newItems.emplace_back(frequency, item);
+	}
+	sort(newItems.begin(), newItems.end(), [](const pair<int, T>& a, const pair<int, T>& b) {
+		return a.first > b.first || (a.first == b.first && a.second < b.second);
+	});
+	for (const auto& [_, item] : newItems) {
+		this->ranks.emplace(item, this->ranks.size());
+	}
+}
+
+template <typename T>
+void SlidingWindow<T>::expireBatch() {
+	assert(!this->batches.empty());
+	for (shared_ptr<FPTreeNode<T>>& handle : this->batches.front()) {
+		this->manager.removeTransaction(move(handle));
+	}
+	this->transactionCount -= this->batches.front().size();
+	this->batches.pop_front();
+	// Items that left the window give back their header table entry and their rank, both follow the items of the window
+	this->manager.headerTable.pruneInfrequent(1);
+	const vector<T> items = this->manager.headerTable.getItems();
+	if (items.size() == this->ranks.size()) {
+		return;
+	}
+	vector<pair<int, T>> ranked;
+	for (const T& item : items) {
+		ranked.emplace_back(this->ranks.at(item), item);
+	}
+	// Only the order of the ranks matters, hence the remaining ones are renumbered from 0
+	sort(ranked.begin(), ranked.end());
+	this->ranks.clear();
+	for (const auto& [_, item] : ranked) {
+		this->ranks.emplace(item, this->ranks.size());
+	}
+}
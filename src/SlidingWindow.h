@@ -0,0 +1,43 @@
+#ifndef FREQUENTPATTERNMINING_SLIDINGWINDOW_H
+#define FREQUENTPATTERNMINING_SLIDINGWINDOW_H
+
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+#include "FPTreeManager.h"
+#include "Itemset.h"
+
+/**
+ * Keeps an FP-Tree over the last batches of transactions, inserting the new ones and expiring the oldest ones without
+ * rebuilding it. Since the tree outlives the item frequencies of a single batch, the items are ordered by their
+ * frequency in the batch where they have been seen for the first time, and every later item follows the known ones.
+ * For every transaction the last node of its path is kept, so that expiring it only requires to walk back to the root.
+ * The items that leave the window lose their rank and their header table entry, and the tree is mined in place.
+ */
+template <typename T>
+class SlidingWindow {
+public:
+	SlidingWindow(const double supportFraction, const int windowBatches);
+	void addBatch(std::list<std::list<T>>& transactions);
+	int getTransactionCount() const;
+	const std::list<Itemset<T>>& getFrequentItemsets();
+
+private:
+	double supportFraction;
+	int windowBatches;
+	int transactionCount;
+	bool changed;
+	FPTreeManager<T> manager;
+	std::map<T, int> ranks;
+	std::deque<std::vector<std::shared_ptr<FPTreeNode<T>>>> batches;
+	std::list<Itemset<T>> frequentItemsets;
+
+	void rankItems(const std::list<std::list<T>>& transactions);
+	void expireBatch();
+};
+
+template class SlidingWindow<int>;
+
+#endif //FREQUENTPATTERNMINING_SLIDINGWINDOW_H
@@ -0,0 +1,81 @@
+#include <sstream>
+#include "Statistics.h"
+#include "MemoryAccounting.h"
+
+using namespace std;
+
+static const char* COUNTER_NAMES[Statistics::COUNTER_COUNT] = {
+		"nodesAllocated",
+		"prefixTrees",
+		"merges",
+		"projections",
+		"arenaBlocks",
+		"conditionalDatabases",
+		"headerTableLocks",
+		"headerTableContendedLocks",
+		"headerTableLockWaitNanoseconds",
+		"nodeLocks",
+		"nodeContendedLocks",
+		"nodeLockWaitNanoseconds"
+};
+
+Statistics::Phase::Phase(string name) : name(name), start(chrono::steady_clock::now()) { }
+
+Statistics::Phase::~Phase() {
+	if (!enabled) {
+		return;
+	}
+	const double seconds = chrono::duration<double>(chrono::steady_clock::now() - this->start).count();
+	lock_guard<std::mutex> guard(Statistics::mutex);
+	Statistics::phases[this->name] += seconds;
+}
+
+void Statistics::addTasks(const int depth, const long long tasks) {
+	if (!enabled) {
+		return;
+	}
+	vector<long long>& tasksPerDepth = getThreadCounters().tasksPerDepth;
+	if ((int) tasksPerDepth.size() <= depth) {
+		tasksPerDepth.resize(depth + 1, 0);
+	}
+	tasksPerDepth[depth] += tasks;
+}
+
+string Statistics::toJSON() {
+	lock_guard<std::mutex> guard(mutex);
+	array<long long, COUNTER_COUNT> counters = {};
+	vector<long long> tasksPerDepth;
+	for (const unique_ptr<ThreadCounters>& local : threadCounters) {
+		for (int i = 0; i < COUNTER_COUNT; i++) {
+			counters[i] += local->counters[i];
+		}
+		if (tasksPerDepth.size() < local->tasksPerDepth.size()) {
+			tasksPerDepth.resize(local->tasksPerDepth.size(), 0);
+		}
+		for (size_t depth = 0; depth < local->tasksPerDepth.size(); depth++) {
+			tasksPerDepth[depth] += local->tasksPerDepth[depth];
+		}
+	}
+	ostringstream json;
+	json << "{\n  \"phases\": {";
+	for (map<string, double>::const_iterator it = phases.cbegin(); it != phases.cend(); it++) {
+		json << (it == phases.cbegin() ? "" : ",") << "\n    \"" << it->first << "\": " << it->second;
+	}
+	json << "\n  },\n  \"counters\": {";
+	for (int i = 0; i < COUNTER_COUNT; i++) {
+		json << (i == 0 ? "" : ",") << "\n    \"" << COUNTER_NAMES[i] << "\": " << counters[i];
+	}
+	json << "\n  },\n  \"threads\": " << threadCounters.size() << ",\n  \"tasksPerDepth\": [";
+	for (size_t depth = 0; depth < tasksPerDepth.size(); depth++) {
+		json << (depth == 0 ? "" : ", ") << tasksPerDepth[depth];
+	}
+	json << "],\n  \"memory\": " << MemoryAccounting::toJSON("  ") << "\n}\n";
+	return json.str();
+}
+
+Statistics::ThreadCounters* Statistics::registerThread() {
+	lock_guard<std::mutex> guard(mutex);
+	threadCounters.push_back(make_unique<ThreadCounters>());
+	threadCounters.back()->counters.fill(0);
+	return threadCounters.back().get();
+}
@@ -0,0 +1,125 @@
+#ifndef FREQUENTPATTERNMINING_STATISTICS_H
+#define FREQUENTPATTERNMINING_STATISTICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <omp.h>
+
+/**
+ * Instrumentation of the engine, turned on by the programs reporting it before mining starts: while it is off every
+ * counter and lock costs a single branch on a static flag, before any thread local data is reached. Every thread updates
+ * its own counters without any synchronization and they are summed only when the report is requested, after the
+ * parallel work is over. Locks are first tried without blocking, so that the waiting time is measured only for the
+ * contended acquisitions.
+ */
+class Statistics {
+public:
+	enum Counter {
+		NODES_ALLOCATED,
+		PREFIX_TREES,
+		MERGES,
+		PROJECTIONS,
+		ARENA_BLOCKS,
+		CONDITIONAL_DATABASES,
+		HEADER_TABLE_LOCKS,
+		HEADER_TABLE_CONTENDED_LOCKS,
+		HEADER_TABLE_LOCK_WAIT,
+		NODE_LOCKS,
+		NODE_CONTENDED_LOCKS,
+		NODE_LOCK_WAIT,
+		COUNTER_COUNT
+	};
+
+	/**
+	 * Adds the wall time between its construction and its destruction to the given phase.
+	 */
+	class Phase {
+	public:
+		Phase(std::string name);
+		~Phase();
+
+	private:
+		std::string name;
+		std::chrono::steady_clock::time_point start;
+	};
+
+	inline static bool enabled = false;
+
+	static void increment(const Counter counter, const long long amount = 1);
+	static void addTasks(const int depth, const long long tasks);
+	static void setLock(omp_lock_t* lock, const Counter acquisitions);
+	static void setLock(std::atomic_flag* lock, const Counter acquisitions);
+	static std::string toJSON();
+
+private:
+	struct ThreadCounters {
+		std::array<long long, COUNTER_COUNT> counters;
+		std::vector<long long> tasksPerDepth;
+	};
+
+	inline static std::mutex mutex;
+	inline static std::list<std::unique_ptr<ThreadCounters>> threadCounters;
+	inline static std::map<std::string, double> phases;
+
+	static ThreadCounters& getThreadCounters();
+	static ThreadCounters* registerThread();
+};
+
+inline Statistics::ThreadCounters& Statistics::getThreadCounters() {
+	thread_local ThreadCounters* local = registerThread();
+	return *local;
+}
+
+inline void Statistics::increment(const Counter counter, const long long amount) {
+	if (!enabled) {
+		return;
+	}
+	getThreadCounters().counters[counter] += amount;
+}
+
+inline void Statistics::setLock(omp_lock_t* lock, const Counter acquisitions) {
+	if (!enabled) {
+		omp_set_lock(lock);
+		return;
+	}
+	// The counters of the contended acquisitions and of their waiting time follow the one of the acquisitions
+	ThreadCounters& local = getThreadCounters();
+	local.counters[acquisitions]++;
+	if (omp_test_lock(lock)) {
+		return;
+	}
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	omp_set_lock(lock);
+	local.counters[acquisitions + 1]++;
+	local.counters[acquisitions + 2] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline void Statistics::setLock(std::atomic_flag* lock, const Counter acquisitions) {
+	if (!enabled) {
+		while (lock->test_and_set(std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+		return;
+	}
+	ThreadCounters& local = getThreadCounters();
+	local.counters[acquisitions]++;
+	if (!lock->test_and_set(std::memory_order_acquire)) {
+		return;
+	}
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	while (lock->test_and_set(std::memory_order_acquire)) {
+		std::this_thread::yield();
+	}
+	local.counters[acquisitions + 1]++;
+	local.counters[acquisitions + 2] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif //FREQUENTPATTERNMINING_STATISTICS_H
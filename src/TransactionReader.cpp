@@ -0,0 +1,65 @@
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include "TransactionReader.h"
+#include "Params.h"
+
+using namespace std;
+
+TransactionReader::TransactionReader() : transactionCount(0) { }
+
+list<int> TransactionReader::getNextOrderedTransaction() {
+	list<int> itemset = this->getNextTransaction();
+	if (!itemset.empty()) {
+		itemset.sort([&](int a, int b) { return this->precedes(a, b); });
+		// We do not take into consideration duplicate elements
+		itemset.unique();
+		DEBUG(
+				ostringstream str;
+				copy(itemset.cbegin(), itemset.cend(), ostream_iterator<int>(str, " "));
+				cout << "Read ordered itemset: " << str.str();
+		)
+	}
+	return itemset; // RVO
+}
+
+const map<int, int>& TransactionReader::getFrequencies() const {
+	return this->frequencies;
+}
+
+int TransactionReader::getTransactionCount() const {
+	return this->transactionCount;
+}
+
+/**
+ * Number of transactions an itemset must appear in to be frequent, the same for every engine mining the reader.
+ */
+int TransactionReader::getSupportCount(const double supportFraction) const {
+	return this->transactionCount * supportFraction;
+}
+
+bool TransactionReader::precedes(int a, int b) const {
+	const int frequencyA = this->frequencies.at(a), frequencyB = this->frequencies.at(b);
+	// Ties are broken by item so that every transaction is sorted according to the same total order
+	return frequencyA > frequencyB || (frequencyA == frequencyB && a < b);
+}
+
+TransactionReader::operator string() const {
+	ostringstream outStream;
+	outStream << setw(10) << "Item" << " | " << setw(10) << "Frequency" << endl;
+	for (const pair<int, int>& p : this->frequencies) {
+		outStream << setw(10) << (string("'") + to_string(p.first) + string("'")) << " | " << setw(10) << p.second << endl;
+	}
+	return outStream.str();
+}
+
+void TransactionReader::increaseFrequency(int item) {
+	map<int, int>::iterator lb = this->frequencies.lower_bound(item);
+	// Checks whether we are performing an add or an update
+	if (lb != this->frequencies.cend() && !(this->frequencies.key_comp()(item, lb->first))) {
+		lb->second++;
+	} else {
+		this->frequencies.insert(lb, map<int, int>::value_type(item, 1));
+	}
+}
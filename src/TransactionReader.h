@@ -0,0 +1,37 @@
+#ifndef FREQUENTPATTERNMINING_TRANSACTION_READER_H
+#define FREQUENTPATTERNMINING_TRANSACTION_READER_H
+
+#include <list>
+#include <map>
+#include <string>
+
+/**
+ * Source of transactions for the FP-Tree construction. Implementations determine the frequency of each item before the
+ * first transaction is requested, so that every transaction can be reordered based on decreasing item frequency.
+ * Warning: Multiple identical items in the same transaction will be simplified to one.
+ */
+class TransactionReader {
+public:
+	TransactionReader();
+	virtual ~TransactionReader() = default;
+	virtual std::list<int> getNextTransaction() = 0;
+	virtual bool isEOF() const = 0;
+	virtual std::list<int> getNextOrderedTransaction();
+	const std::map<int, int>& getFrequencies() const;
+	int getTransactionCount() const;
+	int getSupportCount(const double supportFraction) const;
+	bool precedes(int a, int b) const;
+	operator std::string() const;
+
+protected:
+	std::map<int, int> frequencies;
+	int transactionCount;
+
+	void increaseFrequency(int item);
+};
+
+inline std::ostream& operator << (std::ostream& out, const TransactionReader& transactionReader) {
+	return out << (std::string) transactionReader;
+}
+
+#endif //FREQUENTPATTERNMINING_TRANSACTION_READER_H
@@ -1,36 +1,170 @@
 #include <boost/program_options.hpp>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <queue>
+#include <set>
 #include <iostream>
+#include <sstream>
 #include <omp.h>
+#include <unistd.h>
+#include "DatasetProfile.h"
 #include "FileOrderedReader.h"
 #include "FPTreeManager.h"
+#include "FPTreeSnapshot.h"
 #include "FrequentItemsets.h"
+#include "FrequentPatternMiner.h"
+#include "MemoryAccounting.h"
+#include "MiningDaemon.h"
 #include "Params.h"
+#include "ProjectedDatabases.h"
+#include "SampleMiner.h"
+#include "ShardedMiner.h"
+#include "SlidingWindow.h"
+#include "Statistics.h"
 
 using namespace std;
 
+static void writeFrequentItemsets(ostream& output, const list<Itemset<int>>& itemsets, const int supportCount, bool printSupport) {
+	for (const Itemset<int>& itemset : itemsets) {
+		if (itemset.support < supportCount) {
+			continue;
+		}
+		for (int item : itemset.items) {
+			output << item << " ";
+		}
+		if (printSupport) {
+			output << "(" << itemset.support << ")";
+		}
+		output << endl;
+	}
+}
+
+static string getOutputPath(const string& outputFile, const vector<double>& supportFractions, const double supportFraction) {
+	ostringstream path;
+	path << outputFile;
+	if (supportFractions.size() > 1) {
+		path << "." << supportFraction * 100;
+	}
+	return path.str();
+}
+
+/**
+ * Tells whether the file can be written without creating it, i.e. whether it is writable if it exists, otherwise
+ * whether its directory is.
+ */
+static bool isWritable(const string& path) {
+	if (access(path.c_str(), F_OK) == 0) {
+		return access(path.c_str(), W_OK) == 0;
+	}
+	const filesystem::path directory = filesystem::path(path).parent_path();
+	return access(directory.empty() ? "." : directory.c_str(), W_OK | X_OK) == 0;
+}
+
+/**
+ * Prints the count of the frequent itemsets of every support, and writes them unless skipped. Returns false, after
+ * reporting it, when an output file cannot be opened.
+ */
+static bool printFrequentItemsets(const list<Itemset<int>>& itemsets, const vector<double>& supportFractions, const int transactionCount,
+                                  const string& outputFile, bool printSupport, bool skipOutputFrequent) {
+	if (MemoryAccounting::enabled) {
+		cout << MemoryAccounting::getSummary() << endl;
+	}
+	// Itemsets have been mined with the lowest support, the ones for the higher supports are obtained by filtering them
+	for (double supportFraction : supportFractions) {
+		const int supportCount = transactionCount * supportFraction;
+		const long count = count_if(itemsets.cbegin(), itemsets.cend(), [supportCount](const Itemset<int>& itemset) { return itemset.support >= supportCount; });
+		if (supportFractions.size() > 1) {
+			cout << "Support " << supportFraction * 100 << "%: ";
+		}
+		cout << "Found " << count << " frequent itemsets" << endl;
+		if (skipOutputFrequent) {
+			continue;
+		}
+		if (outputFile.empty()) {
+			writeFrequentItemsets(cout, itemsets, supportCount, printSupport);
+			continue;
+		}
+		const string path = getOutputPath(outputFile, supportFractions, supportFraction);
+		ofstream output(path);
+		if (!output.is_open()) {
+			cerr << "Cannot open the output file " << path << endl;
+			return false;
+		}
+		writeFrequentItemsets(output, itemsets, supportCount, printSupport);
+	}
+	return true;
+}
+
+/**
+ * Writes the statistics of the run when main returns, whatever the execution mode.
+ */
+struct StatisticsWriter {
+	std::string path;
+
+	~StatisticsWriter() {
+		if (this->path.empty()) {
+			return;
+		}
+		ofstream output(this->path);
+		if (!(output << Statistics::toJSON())) {
+			cerr << "Cannot write the statistics to " << this->path << endl;
+		}
+	}
+};
+
+/**
+ * Writes the memory samples, one JSON object per line, until main returns.
+ */
+struct MemorySamplesWriter {
+	std::ofstream output;
+
+	~MemorySamplesWriter() {
+		MemoryAccounting::stopSampling();
+	}
+};
+
 int main(int argc, char *argv[]) {
-	double supportFraction;
-	string input;
-	bool skipOutputFrequent, parallelDelete;
-	int nThreads;
+	// The time budget includes reading the input and building the FP-Tree
+	const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	StatisticsWriter statisticsWriter;
+	MemorySamplesWriter memorySamplesWriter;
+	string memorySamples;
+	bool memorySummary;
+	int sampleInterval, timeBudget;
+	vector<double> supportFractions;
+	vector<string> datasets;
+	// Arguments of the local shard workers, the ones of the coordinator without its reports and snapshot
+	vector<string> workerArguments = {argv[0]};
+	string engine, input, outputFile, shardDirectory, projectionDirectory, snapshot, writeSnapshot, daemonSocket, queries;
+	bool skipOutputFrequent, printSupport, shardExternal, outOfCore, sampleOnly, automatic, fixedEngine, fixedPseudoProjection, fixedParallelDelete;
+	int nThreads, shards, shardIndex, shardTimeout, windowBatches, batchSize, cacheSize, daemonWorkers;
+	long long memoryBudget;
+	double sampleFraction, confidence;
+	unsigned int seed;
 	try {
 		boost::program_options::options_description desc("Allowed options");
 		desc.add_options()
 				("help,h", "Print program usage")
 				(
 					"supportFraction,s",
-					boost::program_options::value<double>(&supportFraction)->required()->notifier([](double value) {
-							if (value <= 0 || value > 100) {
-								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
-																															 "supportFraction",
-																															 to_string(value));
+					boost::program_options::value<vector<double>>(&supportFractions)->multitoken()->notifier([](const vector<double>& values) {
+							for (double value : values) {
+								if (value <= 0 || value > 100) {
+									throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																																 "supportFraction",
+																																 to_string(value));
+								}
 							}
 						}
 					),
-					"Set minimum supportFraction fraction in percentage for an itemset to be considered frequent (e.g. 65%), must be a value between 0 excluded and 100 included"
+					"Set minimum supportFraction fraction in percentage for an itemset to be considered frequent (e.g. 65%), must be a value between 0 excluded and 100 included. "
+					"Multiple values can be given to mine once with the lowest one and report the results of every one of them"
 				)
-				("input,i", boost::program_options::value<string>(&input)->required(), "Input file where new-line separated transactions will be read")
+				("input,i", boost::program_options::value<string>(&input), "Input file where new-line separated transactions will be read")
+				("snapshot", boost::program_options::value<string>(&snapshot), "Mine the FP-Tree snapshot previously written with --writeSnapshot instead of reading an input file")
+				("writeSnapshot", boost::program_options::value<string>(&writeSnapshot), "Write a snapshot of the pruned FP-Tree to the given path, it can be mined later with any support not smaller than this one")
 				("threads,t",
 						boost::program_options::value<int>(&nThreads)->default_value(0)->notifier([](int value) {
 							if (value < 0) {
@@ -47,61 +181,606 @@ int main(int argc, char *argv[]) {
 					boost::program_options::bool_switch(&skipOutputFrequent)->default_value(false),
 					"Disables the output of the Frequent Itemsets once computed, only their count will be printed, used during performance evaluation"
 				)
+				("output,f", boost::program_options::value<string>(&outputFile), "Output file where the Frequent Itemsets are written instead of the standard output, followed by the support when more supports are given")
+				(
+					"printSupport,p",
+					boost::program_options::bool_switch(&printSupport)->default_value(false),
+					"Prints the support count of each Frequent Itemset after its items"
+				)
 				(
 					"parallelDelete,e",
-					boost::program_options::bool_switch(&Params::parallelDelete)->default_value(false),
-					"Enables or disables (default) the parallelization of the delete algorithm for nodes in the FP-Tree"
+					boost::program_options::value<bool>(&Params::parallelDelete)->default_value(false)->implicit_value(true),
+					"Enables or disables (default, or =false) the parallelization of the delete algorithm for nodes in the FP-Tree"
+				)
+				(
+					"pseudoProjection",
+					boost::program_options::value<bool>(&Params::pseudoProjection)->default_value(false)->implicit_value(true),
+					"Mines the conditional databases as lists of paths of the initial FP-Tree, building a conditional FP-Tree only for the small ones, disabled with =false"
+				)
+				(
+					"engine",
+					boost::program_options::value<string>(&engine)->default_value("fpgrowth")->notifier([](const string& value) {
+							if (value != "fpgrowth" && value != "lcm") {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "engine",
+																															 value);
+							}
+						}
+					),
+					"Mining engine, fpgrowth for the FP-Tree or lcm for array databases with occurrence delivery, faster on sparse datasets with many items"
+				)
+				(
+					"materializeThreshold",
+					boost::program_options::value<int>(&Params::materializeThreshold)->default_value(Params::materializeThreshold)->notifier([](int value) {
+							if (value < 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "materializeThreshold",
+																															 to_string(value));
+							}
+						}
+					),
+					"Maximum number of paths of a pseudo-projection for its conditional FP-Tree to be built, 0 never builds them and 1 only enumerates single paths"
+				)
+				(
+					"shards,n",
+					boost::program_options::value<int>(&shards)->default_value(0)->notifier([](int value) {
+							if (value < 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "shards",
+																															 to_string(value));
+							}
+						}
+					),
+					"Number of worker processes among which the frequent prefix items are partitioned, 0 disables the sharded execution"
+				)
+				("shardDirectory", boost::program_options::value<string>(&shardDirectory)->default_value("shards"), "Shared directory used by the coordinator and the workers to exchange partitions and results")
+				(
+					"shardExternal",
+					boost::program_options::bool_switch(&shardExternal)->default_value(false),
+					"Do not start the workers locally, wait for workers started elsewhere with --shardIndex on the same shard directory"
+				)
+				("shardIndex", boost::program_options::value<int>(&shardIndex)->default_value(-1), "Run as the worker responsible for the given shard, requires --shards")
+				(
+					"shardTimeout",
+					boost::program_options::value<int>(&shardTimeout)->default_value(3600)->notifier([](int value) {
+							if (value < 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "shardTimeout",
+																															 to_string(value));
+							}
+						}
+					),
+					"Seconds after which the coordinator stops waiting for the shard results and a worker for its items, 0 waits forever"
+				)
+				(
+					"outOfCore,c",
+					boost::program_options::bool_switch(&outOfCore)->default_value(false),
+					"Writes a projected database per frequent item on disk and mines them separately, for datasets whose FP-Tree does not fit in memory"
+				)
+				("projectionDirectory", boost::program_options::value<string>(&projectionDirectory)->default_value("projections"), "Local directory where the projected databases are stored in out-of-core mode")
+				(
+					"memoryBudget",
+					boost::program_options::value<long long>(&memoryBudget)->default_value(1024)->notifier([](long long value) {
+							if (value <= 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "memoryBudget",
+																															 to_string(value));
+							}
+						}
+					),
+					"Memory in MB that can be used to mine projected databases at the same time in out-of-core mode"
+				)
+				(
+					"window,w",
+					boost::program_options::value<int>(&windowBatches)->default_value(0)->notifier([](int value) {
+							if (value < 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "window",
+																															 to_string(value));
+							}
+						}
+					),
+					"Number of batches kept in the sliding window, enables the incremental mode where the input is consumed in batches and mined after each of them, 0 disables it"
+				)
+				(
+					"batchSize,b",
+					boost::program_options::value<int>(&batchSize)->default_value(10000)->notifier([](int value) {
+							if (value <= 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "batchSize",
+																															 to_string(value));
+							}
+						}
+					),
+					"Number of transactions in every batch of the incremental mode"
+				)
+				("queries", boost::program_options::value<string>(&queries), "File of new-line separated itemsets whose exact support is counted on the FP-Tree of the input instead of mining it, the support is not required")
+				("daemon", boost::program_options::value<string>(&daemonSocket), "Run as a daemon answering the mining requests received on the given Unix domain socket, instead of mining the input once")
+				("dataset", boost::program_options::value<vector<string>>(&datasets)->multitoken(), "Datasets loaded by the daemon, given as <name>=<input file>")
+				(
+					"cacheSize",
+					boost::program_options::value<int>(&cacheSize)->default_value(16)->notifier([](int value) {
+							if (value < 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "cacheSize",
+																															 to_string(value));
+							}
+						}
+					),
+					"Number of (dataset, support) results cached by the daemon, 0 disables the cache"
+				)
+				(
+					"daemonWorkers",
+					boost::program_options::value<int>(&daemonWorkers)->default_value(2)->notifier([](int value) {
+							if (value <= 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "daemonWorkers",
+																															 to_string(value));
+							}
+						}
+					),
+					"Number of requests mined at the same time by the daemon, the threads are split evenly among them"
+				)
+				("stats", boost::program_options::value<string>(&statisticsWriter.path), "Write to the given file a JSON report with the time spent in every phase and the counters of the engine")
+				(
+					"memorySummary",
+					boost::program_options::bool_switch(&memorySummary)->default_value(false),
+					"Prints the peak FP-Tree footprint before the frequent itemsets"
+				)
+				("memorySamples", boost::program_options::value<string>(&memorySamples), "Write to the given file the live FP-Tree footprint sampled during the run, one JSON object per line")
+				(
+					"sampleInterval",
+					boost::program_options::value<int>(&sampleInterval)->default_value(100)->notifier([](int value) {
+							if (value <= 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "sampleInterval",
+																															 to_string(value));
+							}
+						}
+					),
+					"Milliseconds between two memory samples"
+				)
+				(
+					"timeBudget",
+					boost::program_options::value<int>(&timeBudget)->default_value(0)->notifier([](int value) {
+							if (value < 0) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "timeBudget",
+																															 to_string(value));
+							}
+						}
+					),
+					"Milliseconds after which mining stops, expanding the prefix items from the most frequent one and writing the itemsets as they are found, 0 disables it"
+				)
+				(
+					"sample",
+					boost::program_options::value<double>(&sampleFraction)->default_value(0)->notifier([](double value) {
+							if (value < 0 || value > 100) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "sample",
+																															 to_string(value));
+							}
+						}
+					),
+					"Percentage of the transactions drawn at random and mined with a lowered support, the candidates and their negative border are then verified in a single pass over the input, 0 disables it"
+				)
+				(
+					"sampleOnly",
+					boost::program_options::bool_switch(&sampleOnly)->default_value(false),
+					"Skips the verification pass and reports the supports estimated from the sample, requires --sample"
+				)
+				(
+					"confidence",
+					boost::program_options::value<double>(&confidence)->default_value(95)->notifier([](double value) {
+							if (value <= 0 || value >= 100) {
+								throw boost::program_options::validation_error(boost::program_options::validation_error::invalid_option_value,
+																															 "confidence",
+																															 to_string(value));
+							}
+						}
+					),
+					"Percentage of confidence of the sample bounds, must be a value between 0 and 100 excluded"
+				)
+				("seed", boost::program_options::value<unsigned int>(&seed)->default_value(1), "Seed of the random sample")
+				(
+					"auto",
+					boost::program_options::bool_switch(&automatic)->default_value(false),
+					"Profiles the input after reading the item frequencies and picks the engine, pseudo-projection, parallel deletion and number of threads not given explicitly"
 				)
 				("debug,d", boost::program_options::bool_switch(&Params::debug)->default_value(false), "Enables debug log statements");
 		boost::program_options::variables_map vm;
-		boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+		const boost::program_options::parsed_options parsedOptions = boost::program_options::parse_command_line(argc, argv, desc);
+		boost::program_options::store(parsedOptions, vm);
+		// The workers would write the same files of the coordinator over each other
+		const set<string> coordinatorOptions = {"stats", "memorySamples", "sampleInterval", "memorySummary", "writeSnapshot"};
+		for (const boost::program_options::option& option : parsedOptions.options) {
+			if (!coordinatorOptions.count(option.string_key)) {
+				workerArguments.insert(workerArguments.end(), option.original_tokens.cbegin(), option.original_tokens.cend());
+			}
+		}
 		if (vm.count("help")) {
 			cout << desc << endl;
 			return 1;
 		}
 		boost::program_options::notify(vm);
+		if (!daemonSocket.empty()) {
+			if (datasets.empty()) {
+				throw boost::program_options::required_option("dataset");
+			}
+		} else if (supportFractions.empty() && queries.empty()) {
+			throw boost::program_options::required_option("supportFraction");
+		} else if (input.empty() && snapshot.empty()) {
+			throw boost::program_options::required_option("input");
+		}
+		if (!queries.empty() && !snapshot.empty()) {
+			// A snapshot holds the pruned tree, hence it does not know the support of the infrequent itemsets
+			throw invalid_argument("The queries are counted on the FP-Tree of an input file given with --input, not on a snapshot");
+		}
+		if (shardIndex >= 0 && (shards == 0 || shardIndex >= shards)) {
+			throw invalid_argument("The shard index must be between 0 and the number of shards given with --shards");
+		}
+		if (timeBudget > 0 && (!snapshot.empty() || !writeSnapshot.empty() || shards > 0 || outOfCore || windowBatches > 0 || !queries.empty() || supportFractions.size() > 1)) {
+			throw invalid_argument("The time budget can only be used to mine an input file in memory with a single support");
+		}
+		if (timeBudget > 0 && Params::pseudoProjection) {
+			// The prefix items are expanded by batches on the conditional FP-Trees, never on projected views
+			throw invalid_argument("The time budget mines the conditional FP-Trees, it cannot be used with --pseudoProjection");
+		}
+		if (sampleFraction > 0 && (!snapshot.empty() || !writeSnapshot.empty() || shards > 0 || shardIndex >= 0 || outOfCore || windowBatches > 0 || !queries.empty() || timeBudget > 0)) {
+			throw invalid_argument("The sample can only be used to mine an input file in memory");
+		}
+		if (sampleOnly && sampleFraction == 0) {
+			throw invalid_argument("The sample only estimates require --sample");
+		}
+		Params::engine = engine == "lcm" ? Engine::LCM : Engine::FP_GROWTH;
+		fixedEngine = !vm["engine"].defaulted();
+		fixedPseudoProjection = !vm["pseudoProjection"].defaulted();
+		fixedParallelDelete = !vm["parallelDelete"].defaulted();
+		if (automatic && (!daemonSocket.empty() || !snapshot.empty() || !writeSnapshot.empty() || shards > 0 || shardIndex >= 0 || outOfCore || windowBatches > 0 || !queries.empty() || timeBudget > 0 || sampleFraction > 0)) {
+			// Those modes build their trees with their own settings, which the profile does not know about
+			throw invalid_argument("The automatic settings can only be used to mine an input file in memory, not with --daemon, --snapshot, --writeSnapshot, "
+			                       "--shards, --shardIndex, --outOfCore, --window, --queries, --timeBudget or --sample");
+		}
+		if (Params::engine == Engine::LCM && (!daemonSocket.empty() || !snapshot.empty() || !writeSnapshot.empty() || shards > 0 || shardIndex >= 0 || outOfCore || windowBatches > 0 || !queries.empty() || timeBudget > 0)) {
+			throw invalid_argument("The LCM engine can only be used to mine an input file in memory");
+		}
 	} catch (exception &e) {
 		cerr << e.what() << endl;
 		return -1;
 	}
-	cout << "Input: " << input << endl;
-	cout << "Support fraction: " << supportFraction << "%" << endl;
 	Params::nThreads = nThreads > 0 ? nThreads : omp_get_max_threads();
 	omp_set_num_threads(Params::nThreads);
 	cout << "OpenMP maximum number of threads: " << Params::nThreads << endl;
 	cout << "Parallel deletion of FP-Tree nodes is " << (Params::parallelDelete ? "enabled" : "disabled") << endl;
+	cout << "Pseudo-projection is " << (Params::pseudoProjection ? "enabled" : "disabled") << endl;
+	cout << "Mining engine: " << engine << endl;
 	DEBUG(cout << "Debug output enabled")
 	omp_set_nested(true); // We would like to control nested parallelization manually
+	// The counters and the footprint are only kept when they are reported, otherwise they would slow down every node
+	Statistics::enabled = !statisticsWriter.path.empty();
+	MemoryAccounting::enabled = memorySummary || Statistics::enabled || !memorySamples.empty();
+	if (!memorySamples.empty()) {
+		memorySamplesWriter.output.open(memorySamples);
+		if (!memorySamplesWriter.output.is_open()) {
+			cerr << "Cannot open the memory samples file " << memorySamples << endl;
+			return -1;
+		}
+		MemoryAccounting::startSampling(chrono::milliseconds(sampleInterval), [&memorySamplesWriter](const string& sample) {
+			memorySamplesWriter.output << sample << endl;
+		});
+	}
 
-	supportFraction /= 100;
+	if (!daemonSocket.empty()) {
+		try {
+			MiningDaemon<int> daemon(daemonSocket, cacheSize, daemonWorkers);
+			for (const string& dataset : datasets) {
+				const size_t separator = dataset.find('=');
+				const string name = dataset.substr(0, separator), path = separator != string::npos ? dataset.substr(separator + 1) : dataset;
+				cout << "Loading dataset " << name << " from " << path << "..." << endl;
+				daemon.addDataset(name, path);
+			}
+			cout << "Listening on " << daemonSocket << "..." << endl;
+			daemon.run();
+		} catch (exception& e) {
+			// A dataset that cannot be read or a socket that cannot be bound
+			cerr << e.what() << endl;
+			return -1;
+		}
+		return 0;
+	}
 
+	cout << "Input: " << (input.empty() ? snapshot : input) << endl;
+	sort(supportFractions.begin(), supportFractions.end());
+	if (!supportFractions.empty()) {
+		cout << "Support fraction: ";
+		for (double& supportFraction : supportFractions) {
+			cout << supportFraction << "% ";
+			supportFraction /= 100;
+		}
+		cout << endl;
+	}
+	// Output files are checked before mining, so that a wrong path does not throw away the results of a long run
+	if (!outputFile.empty() && !skipOutputFrequent) {
+		const vector<double> outputSupports = supportFractions.empty() ? vector<double>(1, 0) : supportFractions;
+		for (const double supportFraction : outputSupports) {
+			const string path = getOutputPath(outputFile, supportFractions, supportFraction);
+			if (!isWritable(path)) {
+				cerr << "Cannot open the output file " << path << endl;
+				return -1;
+			}
+		}
+	}
+
+	if (!queries.empty()) {
+		FileOrderedReader queryReader(queries, false);
+		vector<list<int>> itemsets;
+		while (!queryReader.isEOF()) {
+			list<int> itemset = queryReader.getNextTransaction();
+			if (!itemset.empty()) {
+				itemsets.push_back(move(itemset));
+			}
+		}
+		cout << "Reading input file and computing item frequencies..." << endl;
+		FileOrderedReader reader(input);
+		cout << "Computing initial FP-Tree..." << endl;
+		// The tree is not pruned, hence the support of every itemset is exact
+		FPTreeManager<int> manager(reader, 0);
+		cout << "Counting the support of " << itemsets.size() << " itemsets..." << endl;
+		const vector<int> supports = manager.getSupports(itemsets);
+		if (skipOutputFrequent) {
+			return 0;
+		}
+		ofstream outputStream;
+		if (!outputFile.empty()) {
+			outputStream.open(outputFile);
+			if (!outputStream.is_open()) {
+				cerr << "Cannot open the output file " << outputFile << endl;
+				return -1;
+			}
+		}
+		ostream& output = outputFile.empty() ? cout : outputStream;
+		for (size_t i = 0; i < itemsets.size(); i++) {
+			for (int item : itemsets[i]) {
+				output << item << " ";
+			}
+			output << "(" << supports[i] << ")" << endl;
+		}
+		return 0;
+	}
+
+	// Mining is performed once with the lowest support
+	const double supportFraction = supportFractions.front();
+
+	if (windowBatches > 0) {
+		cout << "Incremental mining over a window of " << windowBatches << " batches of " << batchSize << " transactions..." << endl;
+		FileOrderedReader reader(input, false);
+		SlidingWindow<int> window(supportFraction, windowBatches);
+		for (int batchNumber = 1; !reader.isEOF(); batchNumber++) {
+			list<list<int>> batch;
+			while ((int) batch.size() < batchSize && !reader.isEOF()) {
+				list<int> transaction = reader.getNextTransaction();
+				if (!transaction.empty()) {
+					batch.push_back(move(transaction));
+				}
+			}
+			if (batch.empty()) {
+				break;
+			}
+			window.addBatch(batch);
+			cout << "Batch " << batchNumber << ", window of " << window.getTransactionCount() << " transactions" << endl;
+			if (!printFrequentItemsets(window.getFrequentItemsets(), supportFractions, window.getTransactionCount(), outputFile, printSupport, skipOutputFrequent)) {
+				return -1;
+			}
+		}
+		return 0;
+	}
+
+	if (sampleFraction > 0) {
+		cout << "Drawing a sample of " << sampleFraction << "% of the transactions..." << endl;
+		FileOrderedReader reader(input, false);
+		SampleMiner<int> sampleMiner(sampleFraction / 100, confidence / 100, seed);
+		try {
+			sampleMiner.drawSample(reader);
+		} catch (runtime_error& e) {
+			cerr << e.what() << endl;
+			return -1;
+		}
+		cout << "Sampled " << sampleMiner.getSampleSize() << " of " << sampleMiner.getTransactionCount() << " transactions" << endl;
+		const FrequentPatternMiner<int> miner(Params::nThreads, Params::parallelDelete, Params::pseudoProjection, Params::engine);
+		if (sampleOnly) {
+			cout << "Estimating Frequent Itemsets with support bigger than " << supportFraction * 100 << "% from the sample..." << endl;
+			list<Itemset<int>> estimates;
+			try {
+				estimates = sampleMiner.getEstimates(miner, supportFraction);
+			} catch (runtime_error& e) {
+				cerr << e.what() << endl;
+				return -1;
+			}
+			const double errorBound = sampleMiner.getErrorBound(estimates.size());
+			cout << "Every estimated support is within " << errorBound * 100 << "% (" << (long) (errorBound * sampleMiner.getTransactionCount())
+			     << " transactions) of the true one with confidence " << confidence << "%" << endl;
+			return printFrequentItemsets(estimates, supportFractions, sampleMiner.getTransactionCount(), outputFile, printSupport, skipOutputFrequent) ? 0 : -1;
+		}
+		list<Itemset<int>> itemsets;
+		try {
+			const double loweredSupportFraction = sampleMiner.getLoweredSupportFraction(supportFraction);
+			cout << "Mining the sample with support lowered to " << loweredSupportFraction * 100 << "%..." << endl;
+			FileOrderedReader verificationReader(input, false);
+			itemsets = sampleMiner.mine(verificationReader, miner, supportFraction, batchSize);
+		} catch (runtime_error& e) {
+			cerr << e.what() << endl;
+			return -1;
+		}
+		cout << "Verified " << sampleMiner.getCandidateCount() << " candidates and " << sampleMiner.getBorderCount() << " negative border itemsets" << endl;
+		const list<Itemset<int>>& frequentBorder = sampleMiner.getFrequentBorder();
+		if (frequentBorder.empty()) {
+			cout << "No negative border itemset is frequent, the results are complete" << endl;
+		} else {
+			// Every missing itemset contains a frequent border itemset, the supersets of the other ones are all infrequent
+			cout << frequentBorder.size() << " negative border itemsets are frequent, only their supersets may be missing:" << endl;
+			writeFrequentItemsets(cout, frequentBorder, 0, true);
+		}
+		return printFrequentItemsets(itemsets, supportFractions, sampleMiner.getTransactionCount(), outputFile, printSupport, skipOutputFrequent) ? 0 : -1;
+	}
+
+	if (!snapshot.empty()) {
+		cout << "Mapping FP-Tree snapshot " << snapshot << "..." << endl;
+		unique_ptr<FPTreeSnapshot<int>> treeSnapshot;
+		try {
+			treeSnapshot = make_unique<FPTreeSnapshot<int>>(snapshot);
+		} catch (invalid_argument& e) {
+			cerr << e.what() << endl;
+			return -1;
+		}
+		const int supportCount = treeSnapshot->getTransactionCount() * supportFraction;
+		if (supportCount < treeSnapshot->getSupportCount()) {
+			cerr << "The snapshot has been pruned with a support count of " << treeSnapshot->getSupportCount() << ", it cannot be mined with " << supportCount << endl;
+			return -1;
+		}
+		cout << "Computing Frequent Itemsets with support bigger than " << supportFraction * 100 << "%..." << endl;
+		FrequentItemsets<int> frequentItemsets(*treeSnapshot, supportCount);
+		return printFrequentItemsets(frequentItemsets.getFrequentItemsets(), supportFractions, treeSnapshot->getTransactionCount(), outputFile, printSupport, skipOutputFrequent) ? 0 : -1;
+	}
+
+	if (shards > 0 && shardIndex < 0) {
+		// The results of a previous run are removed before any worker may find its assignment
+		ShardedMiner<int>(shardDirectory, shards).clear();
+	}
 	cout << "Reading input file and computing item frequencies..." << endl;
 	FileOrderedReader reader(input);
 	if (!skipOutputFrequent) {
 		cout << "Computed frequencies:" << endl << (string) reader << endl;
 	}
 
+	if (automatic) {
+		// Only the settings not given explicitly are chosen
+		const DatasetProfile profile(reader, supportFraction);
+		// The other settings follow the engine that actually runs
+		const DatasetProfile::Strategy strategy = fixedEngine ? profile.getStrategy(omp_get_num_procs(), Params::engine) : profile.getStrategy(omp_get_num_procs(), memoryBudget << 20);
+		cout << "Dataset profile: " << profile << endl;
+		cout << "Automatic settings: " << strategy << endl;
+		Params::engine = strategy.engine;
+		if (!fixedPseudoProjection) {
+			Params::pseudoProjection = strategy.pseudoProjection;
+		}
+		if (!fixedParallelDelete) {
+			Params::parallelDelete = strategy.parallelDelete;
+		}
+		if (nThreads == 0) {
+			Params::nThreads = strategy.nThreads;
+			omp_set_num_threads(Params::nThreads);
+		}
+		cout << "Mining engine: " << (Params::engine == Engine::LCM ? "lcm" : "fpgrowth") << ", threads: " << Params::nThreads
+		     << ", pseudo-projection: " << (Params::pseudoProjection ? "enabled" : "disabled") << ", parallel deletion: " << (Params::parallelDelete ? "enabled" : "disabled") << endl;
+	}
+
+	if (outOfCore) {
+		cout << "Computing Frequent Itemsets with support bigger than " << supportFraction * 100 << "% from projected databases in " << projectionDirectory << "..." << endl;
+		ProjectedDatabases<int> projectedDatabases(reader, supportFraction, projectionDirectory, memoryBudget << 20);
+		return printFrequentItemsets(projectedDatabases.getFrequentItemsets(), supportFractions, reader.getTransactionCount(), outputFile, printSupport, skipOutputFrequent) ? 0 : -1;
+	}
+
+	if (timeBudget > 0) {
+		cout << "Computing initial FP-Tree..." << endl;
+		FPTreeManager<int> manager(reader, supportFraction);
+		cout << "Computing Frequent Itemsets with support bigger than " << supportFraction * 100 << "% within " << timeBudget << " ms..." << endl;
+		ofstream outputStream;
+		if (!outputFile.empty()) {
+			outputStream.open(outputFile);
+			if (!outputStream.is_open()) {
+				cerr << "Cannot open the output file " << outputFile << endl;
+				return -1;
+			}
+		}
+		ostream& output = outputFile.empty() ? cout : outputStream;
+		// Itemsets are written as soon as every prefix item of a batch has been expanded
+		long count = 0;
+		FrequentItemsets<int> frequentItemsets(manager, start + chrono::milliseconds(timeBudget), [&](const list<Itemset<int>>& itemsets, const int completeSupportCount) {
+			count += itemsets.size();
+			if (!skipOutputFrequent) {
+				writeFrequentItemsets(output, itemsets, 0, printSupport);
+			}
+			// The progress would be mixed with the itemsets on the standard output
+			if (skipOutputFrequent || !outputFile.empty()) {
+				cout << "Batch of " << itemsets.size() << " itemsets, results complete for supports of at least "
+				     << completeSupportCount * 100.0 / reader.getTransactionCount() << "% (" << completeSupportCount << " transactions)" << endl;
+			}
+		});
+		const int completeSupportCount = frequentItemsets.getCompleteSupportCount();
+		if (MemoryAccounting::enabled) {
+			cout << MemoryAccounting::getSummary() << endl;
+		}
+		cout << "Found " << count << " frequent itemsets" << endl;
+		cout << "Results are complete for supports of at least " << completeSupportCount * 100.0 / reader.getTransactionCount() << "% (" << completeSupportCount << " transactions)" << endl;
+		return 0;
+	}
+
+	if (writeSnapshot.empty() && shards == 0 && shardIndex < 0) {
+		// Items are mined as their frequency ranks in the narrowest type that holds all of them
+		const size_t itemCount = reader.getFrequencies().size();
+		cout << "Computing Frequent Itemsets with support bigger than " << supportFraction * 100 << "% over " << itemCount << " items as "
+		     << FrequentPatternMiner<int>::getItemBits(itemCount) << " bit ids..." << endl;
+		FrequentPatternMiner<int> miner(Params::nThreads, Params::parallelDelete, Params::pseudoProjection, Params::engine);
+		return printFrequentItemsets(miner.mine(reader, supportFraction), supportFractions, reader.getTransactionCount(), outputFile, printSupport, skipOutputFrequent) ? 0 : -1;
+	}
+
 	cout << "Computing initial FP-Tree..." << endl;
 	FPTreeManager<int> manager(reader, supportFraction);
 	DEBUG(
-		const shared_ptr<FPTreeNode<int>> root = manager.getRoot();
+		const FPTreeNode<int>* root = manager.getRoot();
 		cout << "FP-Tree created:" << endl << manager << endl;
 		const HeaderTable<int>& headerTable = manager.getHeaderTable();
 		cout << endl << headerTable << endl;
 	)
 
+	if (!writeSnapshot.empty()) {
+		cout << "Writing FP-Tree snapshot " << writeSnapshot << "..." << endl;
+		#pragma omp parallel shared(manager) default(none)
+		#pragma omp single
+		manager.pruneInfrequent();
+		try {
+			FPTreeSnapshot<int>::write(manager, reader.getTransactionCount(), writeSnapshot);
+		} catch (runtime_error& e) {
+			cerr << e.what() << endl;
+			return -1;
+		}
+	}
+
 	cout << "Computing Frequent Itemsets with support bigger than " << supportFraction * 100 << "%..." << endl;
-	FrequentItemsets<int> frequentItemsets(manager);
-	const list<list<int>> itemsets = frequentItemsets.getFrequentItemsets();
-	cout << "Found " << itemsets.size() << " frequent itemsets" << endl;
-	if (!skipOutputFrequent) {
-		for (const list<int>& itemset : itemsets) {
-			for (int item : itemset) {
-				cout << item << " ";
+	list<Itemset<int>> itemsets;
+	if (shardIndex >= 0) {
+		ShardedMiner<int> shardedMiner(shardDirectory, shards, chrono::seconds(shardTimeout));
+		try {
+			itemsets = shardedMiner.mineShard(manager, shardIndex);
+		} catch (runtime_error& e) {
+			cerr << e.what() << endl;
+			return -1;
+		}
+		// Results are collected by the coordinator from the shard directory
+		skipOutputFrequent = true;
+	} else if (shards > 0) {
+		ShardedMiner<int> shardedMiner(shardDirectory, shards, chrono::seconds(shardTimeout));
+		shardedMiner.partition(manager);
+		if (!shardExternal) {
+			// The workers share the cores, unless their threads are given explicitly
+			const int workerThreads = nThreads == 0 ? max(1, omp_get_num_procs() / shards) : 0;
+			cout << "Starting " << shards << " shard workers..." << endl;
+			vector<char*> workerArgv;
+			for (string& argument : workerArguments) {
+				workerArgv.push_back(argument.data());
 			}
-			cout << endl;
+			shardedMiner.spawnWorkers(workerArgv.size(), workerArgv.data(), workerThreads);
+		}
+		cout << "Waiting for shard results in " << shardDirectory << "..." << endl;
+		try {
+			itemsets = shardedMiner.collect();
+		} catch (runtime_error& e) {
+			cerr << e.what() << endl;
+			return -1;
 		}
+	} else {
+		FrequentItemsets<int> frequentItemsets(manager);
+		itemsets = frequentItemsets.getFrequentItemsets();
 	}
-
-	return 0;
+	return printFrequentItemsets(itemsets, supportFractions, reader.getTransactionCount(), outputFile, printSupport, skipOutputFrequent) ? 0 : -1;
 }
\ No newline at end of file
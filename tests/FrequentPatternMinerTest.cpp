@@ -0,0 +1,40 @@
+#include <list>
+#include <thread>
+#include <vector>
+#include "FrequentPatternMiner.h"
+#include "TestUtils.h"
+
+using namespace std;
+
+/**
+ * Mines the transactions of a dataset held in memory through the embedding API and checks the itemsets delivered to
+ * the callback against plain FP-growth, with both engines running at the same time.
+ */
+int main() {
+	const double supportFraction = 0.2;
+	const vector<vector<int>> transactions = TestUtils::readTransactions("mushroom.dat");
+	const TestUtils::Supports expected = TestUtils::mineReference("mushroom.dat", supportFraction);
+	TestUtils::Supports fpGrowth, lcm;
+	int fpGrowthCount, lcmCount;
+	// Miners with different settings must not interfere
+	thread fpGrowthThread([&]() {
+		const FrequentPatternMiner<int> miner(2, true, false, Engine::FP_GROWTH);
+		fpGrowthCount = miner.mine(transactions.cbegin(), transactions.cend(), supportFraction, [&fpGrowth](const list<int>& items, const int support) {
+			TestUtils::addItemset(fpGrowth, items, support);
+		});
+	});
+	thread lcmThread([&]() {
+		const FrequentPatternMiner<int> miner(2, false, false, Engine::LCM);
+		lcmCount = miner.mine(transactions.cbegin(), transactions.cend(), supportFraction, [&lcm](const list<int>& items, const int support) {
+			TestUtils::addItemset(lcm, items, support);
+		});
+	});
+	fpGrowthThread.join();
+	lcmThread.join();
+	bool passed = TestUtils::compare(expected, fpGrowth, "FP-growth miner") && TestUtils::compare(expected, lcm, "LCM miner");
+	if (fpGrowthCount != (int) fpGrowth.size() || lcmCount != (int) lcm.size()) {
+		cerr << "The miners returned " << fpGrowthCount << " and " << lcmCount << " itemsets instead of the ones delivered" << endl;
+		passed = false;
+	}
+	return passed ? 0 : 1;
+}
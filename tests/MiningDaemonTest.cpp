@@ -0,0 +1,106 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include "MiningDaemon.h"
+#include "TestUtils.h"
+
+using namespace std;
+
+/**
+ * Connects to the daemon, waiting for it to listen, sends the requests and returns everything received until the daemon
+ * closes the connection.
+ */
+static string sendRequests(const string& socketPath, const string& requests) {
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, socketPath.c_str());
+	int connection = -1;
+	for (int attempt = 0; attempt < 600 && connection < 0; attempt++) {
+		connection = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (connect(connection, (sockaddr*) &address, sizeof(address)) < 0) {
+			close(connection);
+			connection = -1;
+			this_thread::sleep_for(chrono::milliseconds(100));
+		}
+	}
+	if (connection < 0) {
+		return "";
+	}
+	send(connection, requests.data(), requests.size(), MSG_NOSIGNAL);
+	string responses;
+	char chunk[4096];
+	for (ssize_t size; (size = recv(connection, chunk, sizeof(chunk), 0)) > 0;) {
+		responses.append(chunk, size);
+	}
+	close(connection);
+	return responses;
+}
+
+/**
+ * Starts a daemon over a bundled dataset and checks a MINE and a COUNT round trip against plain FP-growth, the errors of
+ * an unknown dataset and of a support below one transaction, and the shutdown.
+ */
+int main() {
+	const string socketPath = filesystem::temp_directory_path() / ("MiningDaemonTest." + to_string(getpid()) + ".sock");
+	const TestUtils::Supports expected = TestUtils::mineReference("mushroom.dat", 0.2);
+	// The support of the longest itemset is counted by the daemon too
+	const auto longest = max_element(expected.cbegin(), expected.cend(), [](const auto& a, const auto& b) { return a.first.size() < b.first.size(); });
+	ostringstream requests;
+	requests << "MINE mushroom 20\nCOUNT mushroom";
+	for (const int item : longest->first) {
+		requests << " " << item;
+	}
+	requests << "\nCOUNT unknown 1\nMINE mushroom 0.001\nSHUTDOWN\n";
+
+	MiningDaemon<int> daemon(socketPath, 4, 2);
+	daemon.addDataset("mushroom", TestUtils::getPath("mushroom.dat"));
+	thread server([&daemon]() {
+		daemon.run();
+	});
+	istringstream responses(sendRequests(socketPath, requests.str()));
+	server.join();
+
+	bool passed = true;
+	string line, status;
+	int count = 0;
+	if (!getline(responses, line) || !(istringstream(line) >> status >> count) || status != "OK") {
+		cerr << "Unexpected MINE response: " << line << endl;
+		return 1;
+	}
+	TestUtils::Supports mined;
+	for (int i = 0; i < count && getline(responses, line); i++) {
+		// Every itemset is followed by its support in brackets
+		const size_t bracket = line.find('(');
+		istringstream itemsLine(line.substr(0, bracket));
+		list<int> items;
+		for (int item; itemsLine >> item;) {
+			items.push_back(item);
+		}
+		TestUtils::addItemset(mined, items, stoi(line.substr(bracket + 1)));
+	}
+	passed = TestUtils::compare(expected, mined, "MINE") && passed;
+	if (!getline(responses, line) || line != "OK " + to_string(longest->second)) {
+		cerr << "COUNT answered " << line << " instead of OK " << longest->second << endl;
+		passed = false;
+	}
+	if (!getline(responses, line) || line.rfind("ERROR ", 0) != 0) {
+		cerr << "COUNT of an unknown dataset answered " << line << " instead of an error" << endl;
+		passed = false;
+	}
+	if (!getline(responses, line) || line.rfind("ERROR ", 0) != 0) {
+		cerr << "MINE with a support below one transaction answered " << line << " instead of an error" << endl;
+		passed = false;
+	}
+	if (!getline(responses, line) || line != "OK") {
+		cerr << "SHUTDOWN answered " << line << endl;
+		passed = false;
+	}
+	return passed ? 0 : 1;
+}
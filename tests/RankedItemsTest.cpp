@@ -0,0 +1,52 @@
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "FrequentPatternMiner.h"
+#include "MemoryOrderedReader.h"
+#include "TestUtils.h"
+
+using namespace std;
+
+/**
+ * Frequent itemsets of plain FP-growth over the int items of transactions held in memory.
+ */
+static TestUtils::Supports mineReference(const vector<vector<int>>& transactions, const double supportFraction) {
+	MemoryOrderedReader reader(transactions.cbegin(), transactions.cend());
+	FPTreeManager<int> manager(reader, supportFraction);
+	FrequentItemsets<int> frequentItemsets(manager);
+	return TestUtils::toSupports(frequentItemsets.getFrequentItemsets());
+}
+
+static TestUtils::Supports mineRanks(const vector<vector<int>>& transactions, const double supportFraction) {
+	MemoryOrderedReader reader(transactions.cbegin(), transactions.cend());
+	return TestUtils::toSupports(FrequentPatternMiner<int>(2).mine(reader, supportFraction));
+}
+
+/**
+ * Checks that mining the frequency ranks of the items and mapping them back gives the same itemsets as mining the int
+ * items themselves, with 16 bit ranks on a bundled dataset and with 32 bit ones on more distinct items than 16 bits hold.
+ */
+int main() {
+	bool passed = true;
+	if (FrequentPatternMiner<int>::getItemBits(UINT16_MAX) != 16 || FrequentPatternMiner<int>::getItemBits(UINT16_MAX + 1) != 32 ||
+	    FrequentPatternMiner<int>::getItemBits(UINT32_MAX) != 32 || FrequentPatternMiner<int>::getItemBits((size_t) UINT32_MAX + 1) != 64) {
+		cerr << "The rank types do not change at the limits of 16 and 32 bits" << endl;
+		passed = false;
+	}
+	const vector<vector<int>> transactions = TestUtils::readTransactions("mushroom.dat");
+	passed = TestUtils::compare(mineReference(transactions, 0.2), mineRanks(transactions, 0.2), "16 bit ranks") && passed;
+	// Every transaction has a few frequent items, which are not the most frequent ones, and many items found only there
+	vector<vector<int>> wideTransactions;
+	for (int i = 0; i < 100; i++) {
+		vector<int> transaction = {3, 5, 7};
+		if (i % 2 == 0) {
+			transaction.push_back(11);
+		}
+		for (int j = 0; j < 700; j++) {
+			transaction.push_back(1000 + i * 700 + j);
+		}
+		wideTransactions.push_back(transaction);
+	}
+	passed = TestUtils::compare(mineReference(wideTransactions, 0.5), mineRanks(wideTransactions, 0.5), "32 bit ranks") && passed;
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#ifndef FREQUENTPATTERNMINING_TESTUTILS_H
+#define FREQUENTPATTERNMINING_TESTUTILS_H
+
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FileOrderedReader.h"
+#include "FPTreeManager.h"
+#include "FrequentItemsets.h"
+#include "Itemset.h"
+
+/**
+ * Helpers shared by the test programs, which are run by CTest and fail with a non-zero exit code.
+ */
+namespace TestUtils {
+	// Frequent itemsets with their items sorted, so that results found in any order can be compared
+	typedef std::map<std::vector<int>, int> Supports;
+
+	inline std::string getPath(const std::string& dataset) {
+		return std::string(DATASET_DIRECTORY) + "/" + dataset;
+	}
+
+	inline std::vector<std::vector<int>> readTransactions(const std::string& dataset) {
+		FileOrderedReader reader(getPath(dataset), false);
+		std::vector<std::vector<int>> transactions;
+		while (!reader.isEOF()) {
+			const std::list<int> transaction = reader.getNextTransaction();
+			if (!transaction.empty()) {
+				transactions.emplace_back(transaction.cbegin(), transaction.cend());
+			}
+		}
+		return transactions;
+	}
+
+	inline void addItemset(Supports& supports, const std::list<int>& items, const int support) {
+		std::vector<int> sortedItems(items.cbegin(), items.cend());
+		std::sort(sortedItems.begin(), sortedItems.end());
+		supports[sortedItems] = support;
+	}
+
+	inline Supports toSupports(const std::list<Itemset<int>>& itemsets) {
+		Supports supports;
+		for (const Itemset<int>& itemset : itemsets) {
+			addItemset(supports, itemset.items, itemset.support);
+		}
+		return supports;
+	}
+
+	/**
+	 * Frequent itemsets of plain FP-growth over int items, the reference of the other ways of mining.
+	 */
+	inline Supports mineReference(const std::string& dataset, const double supportFraction) {
+		FileOrderedReader reader(getPath(dataset));
+		FPTreeManager<int> manager(reader, supportFraction);
+		FrequentItemsets<int> frequentItemsets(manager);
+		return toSupports(frequentItemsets.getFrequentItemsets());
+	}
+
+	/**
+	 * Reports the first difference between the expected itemsets and the actual ones, if any.
+	 */
+	inline bool compare(const Supports& expected, const Supports& actual, const std::string& name) {
+		if (expected.empty()) {
+			std::cerr << name << ": no itemsets expected" << std::endl;
+			return false;
+		}
+		if (expected == actual) {
+			std::cout << name << ": found the same " << actual.size() << " itemsets" << std::endl;
+			return true;
+		}
+		std::cerr << name << ": found " << actual.size() << " itemsets instead of " << expected.size() << std::endl;
+		const auto [expectedIt, actualIt] = std::mismatch(expected.cbegin(), expected.cend(), actual.cbegin(), actual.cend());
+		const auto& difference = expectedIt != expected.cend() ? *expectedIt : *actualIt;
+		std::cerr << "First difference:";
+		for (const int item : difference.first) {
+			std::cerr << " " << item;
+		}
+		std::cerr << " (" << difference.second << ")" << std::endl;
+		return false;
+	}
+}
+
+#endif //FREQUENTPATTERNMINING_TESTUTILS_H